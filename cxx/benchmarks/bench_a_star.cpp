@@ -0,0 +1,229 @@
+#include <benchmark/benchmark.h>
+
+#include "arthoolbox/algo/path/a_star.hpp"
+#include "arthoolbox/algo/path/grid_a_star.hpp"
+#include "arthoolbox/algo/path/path_searcher.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+
+/// Square grid with random walls (fixed seed), cells are indexed y * size + x
+struct Grid {
+  Grid(const int grid_size, const double wall_ratio)
+      : size(grid_size), walls(grid_size * grid_size, false) {
+    std::mt19937 random_generator(42);
+    std::bernoulli_distribution is_wall(wall_ratio);
+    for (std::size_t i = 0; i < walls.size(); ++i)
+      walls[i] = is_wall(random_generator);
+
+    walls[getStart()] = walls[getGoal()] = false;
+  }
+
+  int getStart() const noexcept { return 0; }
+  int getGoal() const noexcept { return size * size - 1; }
+
+  double manhattan(const int cell, const int to) const noexcept {
+    return std::abs(cell % size - to % size) +
+           std::abs(cell / size - to / size);
+  }
+
+  double manhattan(const int cell) const noexcept {
+    return manhattan(cell, getGoal());
+  }
+
+  /// @return The first free cell at or after (x, y)
+  int getFreeCell(const int x, const int y) const noexcept {
+    int cell = y * size + x;
+    while (walls[cell])
+      ++cell;
+    return cell;
+  }
+
+  std::vector<std::pair<int, double>> neighbors(const int cell) const {
+    std::vector<std::pair<int, double>> out;
+    const int x = cell % size;
+    const int y = cell / size;
+    if ((x > 0) and not walls[cell - 1])
+      out.emplace_back(cell - 1, 1.);
+    if ((x + 1 < size) and not walls[cell + 1])
+      out.emplace_back(cell + 1, 1.);
+    if ((y > 0) and not walls[cell - size])
+      out.emplace_back(cell - size, 1.);
+    if ((y + 1 < size) and not walls[cell + size])
+      out.emplace_back(cell + size, 1.);
+    return out;
+  }
+
+  int size;
+  std::vector<bool> walls;
+};
+
+const Grid &getGrid(const int size = 256) {
+  static std::map<int, Grid> grids;
+  auto grid = grids.find(size);
+  if (grid == grids.end())
+    grid = grids.emplace(size, Grid(size, 0.2)).first;
+  return grid->second;
+}
+
+static void BM_AStarStdFunction(benchmark::State &state) {
+  const auto &grid = getGrid();
+
+  std::size_t expansions = 0;
+  const std::function<double(const int &)> heuristic =
+      [&grid](const int &cell) { return grid.manhattan(cell); };
+  const std::function<std::vector<std::pair<int, double>>(const int &)>
+      neighbors = [&grid, &expansions](const int &cell) {
+        ++expansions;
+        return grid.neighbors(cell);
+      };
+
+  for (auto _ : state) {
+    auto path = aStarShortestPath<int>(grid.getStart(), grid.getGoal(),
+                                       heuristic, neighbors);
+    benchmark::DoNotOptimize(path);
+  }
+  state.counters["expansions"] =
+      benchmark::Counter(expansions, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_AStarStdFunction)->Unit(benchmark::kMillisecond);
+
+static void BM_AStarTemplate(benchmark::State &state) {
+  const auto &grid = getGrid(state.range(0));
+
+  std::size_t expansions = 0;
+  const auto heuristic = [&grid](const int &cell) {
+    return grid.manhattan(cell);
+  };
+  const auto neighbors = [&grid, &expansions](const int &cell) {
+    ++expansions;
+    return grid.neighbors(cell);
+  };
+
+  for (auto _ : state) {
+    auto path = aStarShortestPath<int>(grid.getStart(), grid.getGoal(),
+                                       heuristic, neighbors);
+    benchmark::DoNotOptimize(path);
+  }
+  state.counters["expansions"] =
+      benchmark::Counter(expansions, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_AStarTemplate)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_PathSearcher(benchmark::State &state) {
+  const auto &grid = getGrid(state.range(0));
+
+  std::size_t expansions = 0;
+  const auto heuristic = [&grid](const int &cell) {
+    return grid.manhattan(cell);
+  };
+  std::vector<std::pair<int, double>> buffer;
+  const auto neighbors = [&grid, &buffer](const int &cell) -> const auto & {
+    buffer = grid.neighbors(cell);
+    return buffer;
+  };
+
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+  for (auto _ : state) {
+    searcher.shortestPath(grid.getStart(), grid.getGoal(), heuristic,
+                          neighbors, path);
+    expansions += searcher.getNumberOfExpansions();
+    benchmark::DoNotOptimize(path);
+  }
+  state.counters["expansions"] =
+      benchmark::Counter(expansions, benchmark::Counter::kIsRate);
+  state.counters["open_list_max"] = searcher.getOpenListHighWaterMark();
+}
+BENCHMARK(BM_PathSearcher)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+/// Query between two points in the middle of the grid (a quarter of the size
+/// apart from the borders), with the Manhattan heuristic or none (Dijkstra)
+template <bool Bidirectional>
+static void BM_PathSearcherBidirectional(benchmark::State &state) {
+  const auto &grid = getGrid(state.range(0));
+  const double weight = state.range(1) ? 1. : 0.;
+  const int from = grid.getFreeCell(grid.size / 4, grid.size / 2);
+  const int to = grid.getFreeCell(3 * grid.size / 4, grid.size / 2);
+
+  std::size_t expansions = 0;
+  const auto heuristic_from = [&grid, weight, to](const int &cell) {
+    return weight * grid.manhattan(cell, to);
+  };
+  const auto heuristic_to = [&grid, weight, from](const int &cell) {
+    return weight * grid.manhattan(cell, from);
+  };
+  std::vector<std::pair<int, double>> buffer;
+  const auto neighbors = [&grid, &buffer](const int &cell) -> const auto & {
+    buffer = grid.neighbors(cell);
+    return buffer;
+  };
+
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+  for (auto _ : state) {
+    if constexpr (Bidirectional)
+      searcher.bidirectionalShortestPath(from, to, heuristic_from,
+                                         heuristic_to, neighbors, neighbors,
+                                         path);
+    else
+      searcher.shortestPath(from, to, heuristic_from, neighbors, path);
+    expansions += searcher.getNumberOfExpansions();
+    benchmark::DoNotOptimize(path);
+  }
+  state.counters["expansions"] =
+      benchmark::Counter(expansions, benchmark::Counter::kAvgIterations);
+  state.counters["path_length"] = path.size();
+}
+BENCHMARK_TEMPLATE(BM_PathSearcherBidirectional, false)
+    ->ArgsProduct({{256, 1024}, {0, 1}})
+    ->ArgNames({"size", "heuristic"})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PathSearcherBidirectional, true)
+    ->ArgsProduct({{256, 1024}, {0, 1}})
+    ->ArgNames({"size", "heuristic"})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GridAStar(benchmark::State &state) {
+  const auto &grid = getGrid(state.range(0));
+  const auto size = static_cast<std::size_t>(grid.size);
+
+  GridAStar<2> engine({size, size});
+  const auto isFree = [&grid](std::size_t cell) {
+    return not grid.walls[cell];
+  };
+
+  std::size_t expansions = 0;
+  std::vector<std::size_t> path;
+  for (auto _ : state) {
+    engine.shortestPath({0, 0}, {size - 1, size - 1}, isFree, path);
+    expansions += engine.getNumberOfExpansions();
+    benchmark::DoNotOptimize(path);
+  }
+  state.counters["expansions"] =
+      benchmark::Counter(expansions, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_GridAStar)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Arg(4096)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
+
+BENCHMARK_MAIN();
@@ -0,0 +1,35 @@
+#pragma once
+/**
+ *   \file bench_data.hpp
+ *   \brief Contains the data sets shared by the statistics benchmarks
+ */
+
+#include <algorithm> // generate_n
+#include <cstdlib>   // std::size_t
+#include <iterator>  // back_inserter
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+
+inline std::vector<double>
+generateRandomNormalDistribution(double mean, double stddev,
+                                 std::size_t n) noexcept {
+  // Fixed seed: the same data set is used by every run
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(mean, stddev);
+
+  std::vector<double> out;
+  out.reserve(n);
+
+  std::generate_n(std::back_inserter(out), n,
+                  [&distribution, &random_generator]() {
+                    return distribution(random_generator);
+                  });
+
+  return out;
+}
+
+} // namespace stats
+} // namespace arthoolbox
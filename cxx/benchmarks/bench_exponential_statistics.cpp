@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "arthoolbox/math/exponential_statistics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+
+const std::vector<double> &getRandomData() {
+  static const auto out = [] {
+    std::mt19937 random_generator(42);
+    std::normal_distribution<double> distribution(42, 5e-3);
+
+    std::vector<double> samples;
+    samples.reserve(500);
+    std::generate_n(std::back_inserter(samples), 500,
+                    [&distribution, &random_generator]() {
+                      return distribution(random_generator);
+                    });
+    return samples;
+  }();
+  return out;
+}
+
+static void BM_ComputeExponentialStatistics(benchmark::State &state) {
+  const auto &data = getRandomData();
+
+  for (auto _ : state) {
+    ExponentialStatistics<double> stats(0.05);
+
+    for (const auto &sample : data)
+      stats.updateWith(sample);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeExponentialStatistics);
+
+static void BM_ComputeTimeDecayedStatistics(benchmark::State &state) {
+  using namespace std::chrono_literals;
+  const auto &data = getRandomData();
+
+  // Irregular timestamps, between 1 and 10 ms apart
+  std::vector<std::chrono::steady_clock::time_point> timestamps;
+  std::mt19937 random_generator(42);
+  std::uniform_int_distribution<int> delta_ms(1, 10);
+  std::chrono::steady_clock::time_point now;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    now += std::chrono::milliseconds(delta_ms(random_generator));
+    timestamps.push_back(now);
+  }
+
+  for (auto _ : state) {
+    TimeDecayedStatistics<double> stats(100ms);
+
+    for (std::size_t i = 0; i < data.size(); ++i)
+      stats.updateWith(data[i], timestamps[i]);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeTimeDecayedStatistics);
+
+} // namespace stats
+} // namespace arthoolbox
+
+BENCHMARK_MAIN();
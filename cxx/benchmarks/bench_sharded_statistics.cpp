@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include "arthoolbox/math/sharded_statistics.hpp"
+
+#include <mutex>
+
+namespace arthoolbox {
+namespace stats {
+
+// Baseline: a single RecurrentStatistics protected by a mutex
+struct LockedStatistics {
+  void updateWith(double sample) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.updateWith(sample);
+  }
+
+  std::mutex mutex;
+  RecurrentStatistics<double, double> stats;
+};
+
+static void BM_LockedStatisticsContention(benchmark::State &state) {
+  static LockedStatistics stats;
+
+  double sample = state.thread_index();
+  for (auto _ : state) {
+    stats.updateWith(sample);
+    sample += 1e-3;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LockedStatisticsContention)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+static void BM_ShardedStatisticsContention(benchmark::State &state) {
+  static ShardedStatistics<double> stats(32);
+
+  double sample = state.thread_index();
+  for (auto _ : state) {
+    stats.updateWith(sample);
+    sample += 1e-3;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShardedStatisticsContention)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+static void BM_ShardedStatisticsSnapshot(benchmark::State &state) {
+  ShardedStatistics<double> stats(static_cast<std::size_t>(state.range(0)));
+  stats.updateWith(42.);
+
+  for (auto _ : state) {
+    auto snapshot = stats.snapshot();
+    benchmark::DoNotOptimize(snapshot);
+  }
+}
+BENCHMARK(BM_ShardedStatisticsSnapshot)->RangeMultiplier(2)->Range(1, 32);
+
+} // namespace stats
+} // namespace arthoolbox
+
+BENCHMARK_MAIN();
@@ -1,31 +1,29 @@
 #include <benchmark/benchmark.h>
 
+#include "bench_data.hpp"
+
+#include "arthoolbox/math/accumulator.hpp"
+#include "arthoolbox/math/anomaly.hpp"
+#include "arthoolbox/math/channel_statistics.hpp"
+#include "arthoolbox/math/covariance.hpp"
+#include "arthoolbox/math/histogram.hpp"
+#include "arthoolbox/math/quantile.hpp"
+#include "arthoolbox/math/snapshot.hpp"
 #include "arthoolbox/math/statistics.hpp"
+#include "arthoolbox/math/statistics_table.hpp"
+#include "arthoolbox/math/windowed_statistics.hpp"
 
-#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <random>
+#include <unordered_map>
 #include <vector>
 
 namespace arthoolbox {
 namespace stats {
 
-std::vector<double> generateRandomNormalDistribution(double mean, double stddev,
-                                                     std::size_t n) noexcept {
-  std::random_device seed_generator;
-  std::mt19937 random_generator(seed_generator());
-  std::normal_distribution<double> distribution(mean, stddev);
-
-  std::vector<double> out;
-  out.reserve(n);
-
-  std::generate_n(std::back_inserter(out), n,
-                  [&distribution, &random_generator]() {
-                    return distribution(random_generator);
-                  });
-
-  return out;
-}
-
 const std::vector<double> &getRandomData() {
   static auto out = generateRandomNormalDistribution(42, 5e-3, 500);
   return out;
@@ -86,9 +84,327 @@ static void BM_ComputeRecurringStatistics(benchmark::State &state) {
 
     benchmark::DoNotOptimize(stats);
   }
+  state.SetItemsProcessed(state.iterations() * data.size());
 }
 BENCHMARK(BM_ComputeRecurringStatistics);
 
+static void BM_ComputeRecurringStatisticsBatch(benchmark::State &state) {
+  const auto& data = getRandomData();
+
+  for (auto _ : state) {
+    RecurrentStatistics<double, double> stats;
+    stats.updateWith(data.cbegin(), data.cend());
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeRecurringStatisticsBatch);
+
+const std::vector<double> &getLargeRandomData() {
+  static auto out = generateRandomNormalDistribution(42, 5e-3, 1 << 20);
+  return out;
+}
+
+static void BM_ComputeRecurringStatisticsLarge(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    RecurrentStatistics<double, double> stats;
+    for (std::size_t i = 0; i < n; ++i)
+      stats.updateWith(data[i]);
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ComputeRecurringStatisticsLarge)->Range(1 << 10, 1 << 20);
+
+static void BM_ComputeRecurringStatisticsBatchLarge(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  const auto n = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    RecurrentStatistics<double, double> stats;
+    stats.updateWith(data.cbegin(), data.cbegin() + n);
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ComputeRecurringStatisticsBatchLarge)->Range(1 << 10, 1 << 20);
+
+static void BM_ComputeStatisticsParallel(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  execution::parallel_policy policy;
+  policy.thread_count = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    auto stats = compute_statistics(policy, data.cbegin(), data.cend());
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeStatisticsParallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+static void BM_ComputeWindowedStatistics(benchmark::State &state) {
+  const auto& data = getRandomData();
+
+  for (auto _ : state) {
+    WindowedStatistics<double, 64> stats;
+
+    for(const auto &sample : data)
+      stats.updateWith(sample);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeWindowedStatistics);
+
+static void BM_ComputeTDigest(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  TDigest<double> digest(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state) {
+    digest.reset();
+    for(const auto &sample : data)
+      digest.updateWith(sample);
+
+    auto p99 = digest.quantile(0.99);
+    benchmark::DoNotOptimize(p99);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeTDigest)->Arg(100)->Arg(200)->Arg(500);
+
+static void BM_RecordLogHistogram(benchmark::State &state) {
+  // Same data as BM_ComputeRecurringStatistics, recorded in nanoseconds
+  std::vector<LogHistogram::value_type> data;
+  for (const auto &sample : getRandomData())
+    data.push_back(static_cast<LogHistogram::value_type>(sample * 1e6));
+
+  LogHistogram histogram;
+  for (auto _ : state) {
+    for (const auto &value : data)
+      histogram.record(value);
+
+    benchmark::DoNotOptimize(histogram);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_RecordLogHistogram);
+
+static void BM_ComputeRecurringCovariance(benchmark::State &state) {
+  // 6-DoF samples, built from consecutive values of the random data
+  constexpr std::size_t Dim = 6;
+  const auto& data = getRandomData();
+  const auto n = data.size() / Dim;
+
+  for (auto _ : state) {
+    RecurrentCovariance<double, Dim> stats;
+
+    for (std::size_t i = 0; i < n; ++i)
+      stats.updateWith(data.data() + i * Dim);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ComputeRecurringCovariance);
+
+static void BM_ComputeSeparateLoops(benchmark::State &state) {
+  const auto& data = getRandomData();
+
+  for (auto _ : state) {
+    RecurrentStatistics<double, double> stats;
+    for(const auto &sample : data)
+      stats.updateWith(sample);
+
+    auto min = *std::min_element(data.cbegin(), data.cend());
+    auto max = *std::max_element(data.cbegin(), data.cend());
+
+    benchmark::DoNotOptimize(stats);
+    benchmark::DoNotOptimize(min);
+    benchmark::DoNotOptimize(max);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeSeparateLoops);
+
+static void BM_ComputeAccumulator(benchmark::State &state) {
+  using namespace features;
+  const auto& data = getRandomData();
+
+  for (auto _ : state) {
+    Accumulator<double, Min, Max, Variance> stats;
+    for(const auto &sample : data)
+      stats.updateWith(sample);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeAccumulator);
+
+template <class T, class U>
+static void BM_ComputeRecurringStatisticsPrecision(benchmark::State &state) {
+  const auto& large_data = getLargeRandomData();
+  const std::vector<T> data(large_data.cbegin(), large_data.cend());
+
+  // Two passes reference, computed in long double on the same (rounded) data
+  long double mean = 0, variance = 0;
+  for (const auto &sample : data)
+    mean += sample;
+  mean /= data.size();
+  for (const auto &sample : data)
+    variance += (sample - mean) * (sample - mean);
+  variance /= data.size();
+
+  RecurrentStatistics<T, U> stats;
+  for (auto _ : state) {
+    stats.reset(U{}, U{});
+    for(const auto &sample : data)
+      stats.updateWith(sample);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+
+  const auto computed_mean = static_cast<long double>(T(stats.getMean()));
+  const auto computed_variance =
+      static_cast<long double>(T(stats.getVariance()));
+  state.counters["mean_rel_error"] =
+      static_cast<double>(std::abs((computed_mean - mean) / mean));
+  state.counters["var_rel_error"] =
+      static_cast<double>(std::abs((computed_variance - variance) / variance));
+}
+BENCHMARK_TEMPLATE(BM_ComputeRecurringStatisticsPrecision, float, float);
+BENCHMARK_TEMPLATE(BM_ComputeRecurringStatisticsPrecision, float,
+                   CompensatedSum<float>);
+BENCHMARK_TEMPLATE(BM_ComputeRecurringStatisticsPrecision, double, double);
+BENCHMARK_TEMPLATE(BM_ComputeRecurringStatisticsPrecision, double,
+                   CompensatedSum<double>);
+
+// 64 channels interleaved frames, built from the large random data
+constexpr std::size_t bench_channels = 64;
+
+static void BM_ComputeChannelsWithRecurringStatistics(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  const auto frames = data.size() / bench_channels;
+
+  for (auto _ : state) {
+    std::vector<RecurrentStatistics<double, double>> stats(bench_channels);
+    for (std::size_t f = 0; f < frames; ++f)
+      for (std::size_t c = 0; c < bench_channels; ++c)
+        stats[c].updateWith(data[f * bench_channels + c]);
+
+    benchmark::DoNotOptimize(stats.data());
+  }
+  state.SetItemsProcessed(state.iterations() * frames * bench_channels);
+}
+BENCHMARK(BM_ComputeChannelsWithRecurringStatistics);
+
+static void BM_ComputeChannelStatistics(benchmark::State &state) {
+  const auto& data = getLargeRandomData();
+  const auto frames = data.size() / bench_channels;
+
+  for (auto _ : state) {
+    ChannelStatistics<double, bench_channels> stats;
+    stats.updateWith(data.data(), frames);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * frames * bench_channels);
+}
+BENCHMARK(BM_ComputeChannelStatistics);
+
+static void BM_WriteRecurringStatisticsSnapshot(benchmark::State &state) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(getRandomData().cbegin(), getRandomData().cend());
+
+  char buffer[snapshot::header_size + snapshot::statistics_payload_size];
+  for (auto _ : state) {
+    auto end = snapshot::write(stats, buffer);
+    benchmark::DoNotOptimize(end);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_WriteRecurringStatisticsSnapshot);
+
+constexpr std::uint32_t table_keys = 100000;
+constexpr std::size_t table_records = 1 << 20;
+
+const std::vector<std::uint32_t> &getRandomKeys() {
+  static const auto out = []() {
+    std::mt19937 random_generator(42);
+    std::uniform_int_distribution<std::uint32_t> distribution(0,
+                                                              table_keys - 1);
+    std::vector<std::uint32_t> keys(table_records);
+    for (auto &key : keys)
+      key = distribution(random_generator);
+    return keys;
+  }();
+  return out;
+}
+
+static void BM_RecordUnorderedMap(benchmark::State &state) {
+  const auto &keys = getRandomKeys();
+  const auto &values = getLargeRandomData();
+
+  std::unordered_map<std::uint32_t, RecurrentStatistics<double, double>> map;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      map[keys[i]].updateWith(values[i]);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_RecordUnorderedMap)->Unit(benchmark::kMillisecond);
+
+static void BM_RecordStatisticsTable(benchmark::State &state) {
+  const auto &keys = getRandomKeys();
+  const auto &values = getLargeRandomData();
+
+  StatisticsTable<std::uint32_t> table;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < keys.size(); ++i)
+      table.record(keys[i], values[i]);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_RecordStatisticsTable)->Unit(benchmark::kMillisecond);
+
+static void BM_RecordStatisticsTableBatch(benchmark::State &state) {
+  const auto &keys = getRandomKeys();
+  const auto &values = getLargeRandomData();
+
+  StatisticsTable<std::uint32_t> table;
+  for (auto _ : state) {
+    table.record(keys.data(), values.data(), keys.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_RecordStatisticsTableBatch)->Unit(benchmark::kMillisecond);
+
+static void BM_ComputeZScoreDetector(benchmark::State &state) {
+  const auto &data = getLargeRandomData();
+
+  for (auto _ : state) {
+    ZScoreDetector<RecurrentStatistics<double, double>> detector(
+        RecurrentStatistics<double, double>(), 3., 2., 100);
+    for (const auto &sample : data)
+      detector.updateWith(sample);
+
+    benchmark::DoNotOptimize(detector);
+  }
+  state.SetItemsProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ComputeZScoreDetector);
+
 } // namespace stats
 } // namespace arthoolbox
 
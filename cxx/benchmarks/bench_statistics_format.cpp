@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_data.hpp"
+
+#include "arthoolbox/math/statistics.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <vector>
+
+// Count the allocations, in order to report them on the format benchmarks.
+// Replacing operator new affects every benchmark of the binary: keep this
+// executable for the format benchmarks only.
+static std::atomic<std::size_t> allocations{0};
+
+void *operator new(std::size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace arthoolbox {
+namespace stats {
+
+const std::vector<double> &getRandomData() {
+  static auto out = generateRandomNormalDistribution(42, 5e-3, 500);
+  return out;
+}
+
+static void BM_FormatRecurringStatisticsStream(benchmark::State &state) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(getRandomData().cbegin(), getRandomData().cend());
+
+  // Reference: std::stringstream, as format() does for non arithmetic types
+  const auto allocations_before = allocations.load();
+  for (auto _ : state) {
+    std::stringstream output;
+    output << "Stats [N = " << stats.getNumberOfMeasurements();
+    output << "]\nMean: " << stats.getMean();
+    output << "\nVar : " << stats.getVariance();
+    output << "\nSVar: " << stats.getSampledVariance();
+    auto text = output.str();
+    benchmark::DoNotOptimize(text);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      allocations.load() - allocations_before,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FormatRecurringStatisticsStream);
+
+static void BM_FormatRecurringStatistics(benchmark::State &state) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(getRandomData().cbegin(), getRandomData().cend());
+
+  const auto allocations_before = allocations.load();
+  for (auto _ : state) {
+    auto text = format(stats);
+    benchmark::DoNotOptimize(text);
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      allocations.load() - allocations_before,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FormatRecurringStatistics);
+
+static void BM_FormatToRecurringStatistics(benchmark::State &state) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(getRandomData().cbegin(), getRandomData().cend());
+  const auto style = static_cast<FormatStyle>(state.range(0));
+
+  char buffer[256];
+  const auto allocations_before = allocations.load();
+  for (auto _ : state) {
+    auto result = format_to_n(buffer, sizeof(buffer), stats, style);
+    benchmark::DoNotOptimize(result);
+    benchmark::ClobberMemory();
+  }
+  state.counters["allocations"] = benchmark::Counter(
+      allocations.load() - allocations_before,
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FormatToRecurringStatistics)
+    ->Arg(static_cast<int>(FormatStyle::Multiline))
+    ->Arg(static_cast<int>(FormatStyle::Compact));
+
+} // namespace stats
+} // namespace arthoolbox
+
+BENCHMARK_MAIN();
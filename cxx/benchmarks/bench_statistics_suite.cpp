@@ -0,0 +1,142 @@
+/**
+ *   \file bench_statistics_suite.cpp
+ *   \brief Parameterized benchmarks of the RecurrentStatistics kernels
+ *
+ *   Each benchmark processes N samples (1e2 to 1e8), drawn with a fixed seed,
+ *   either:
+ *   - Cache resident: the same cache_resident_samples samples are processed
+ *     N / cache_resident_samples times;
+ *   - Streaming: N distinct samples are processed (up to max_streaming_samples
+ *     to bound the memory used).
+ *
+ *   The mean/variance relative errors, against a two passes long double
+ *   reference computed on the same samples, are reported as counters.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "arthoolbox/math/statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+constexpr std::uint32_t seed = 42;
+constexpr std::int64_t min_samples = 100;
+constexpr std::int64_t max_samples = 100000000;
+constexpr std::int64_t max_streaming_samples = 10000000;
+constexpr std::size_t cache_resident_samples = 10000;
+
+/// Large mean and small deviation: the hard case for naive algorithms
+constexpr double data_mean = 42;
+constexpr double data_stddev = 5e-3;
+
+template <class T> const std::vector<T> &getData(const std::size_t n) {
+  static std::vector<T> data;
+  static std::mt19937 random_generator(seed);
+  static std::normal_distribution<double> distribution(data_mean,
+                                                       data_stddev);
+
+  // The data is only extended: a given sample is always the same
+  if (data.size() < n) {
+    data.reserve(n);
+    std::generate_n(std::back_inserter(data), n - data.size(), []() {
+      return static_cast<T>(distribution(random_generator));
+    });
+  }
+
+  return data;
+}
+
+struct Reference {
+  long double mean;
+  long double variance;
+};
+
+template <class T>
+Reference computeReference(const T *first, const std::size_t n) {
+  Reference out{0, 0};
+  for (std::size_t i = 0; i < n; ++i)
+    out.mean += first[i];
+  out.mean /= n;
+  for (std::size_t i = 0; i < n; ++i)
+    out.variance += (first[i] - out.mean) * (first[i] - out.mean);
+  out.variance /= n;
+  return out;
+}
+
+/// Call RecurrentStatistics::updateWith(x) for each sample
+struct PerSample {
+  template <class Stats, class T>
+  static void run(Stats &stats, const T *first, const T *last) {
+    for (; first != last; ++first)
+      stats.updateWith(*first);
+  }
+};
+
+/// Call RecurrentStatistics::updateWith(first, last)
+struct Batch {
+  template <class Stats, class T>
+  static void run(Stats &stats, const T *first, const T *last) {
+    stats.updateWith(first, last);
+  }
+};
+
+template <class T, class Kernel, bool Streaming>
+void BM_Statistics(benchmark::State &state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const std::size_t chunk =
+      Streaming ? n : std::min(n, cache_resident_samples);
+  const std::size_t repeat = n / chunk;
+  const T *data = getData<T>(chunk).data();
+
+  RecurrentStatistics<T, T> stats;
+  for (auto _ : state) {
+    stats.reset(T{}, T{});
+    for (std::size_t i = 0; i < repeat; ++i)
+      Kernel::run(stats, data, data + chunk);
+
+    benchmark::DoNotOptimize(stats);
+  }
+  state.SetItemsProcessed(state.iterations() * repeat * chunk);
+  state.SetBytesProcessed(state.iterations() * repeat * chunk * sizeof(T));
+
+  // Repeating the same samples doesn't change the mean/variance
+  const auto reference = computeReference(data, chunk);
+  state.counters["mean_rel_error"] = static_cast<double>(std::abs(
+      (static_cast<long double>(stats.getMean()) - reference.mean) /
+      reference.mean));
+  state.counters["var_rel_error"] = static_cast<double>(std::abs(
+      (static_cast<long double>(stats.getVariance()) - reference.variance) /
+      reference.variance));
+}
+
+#define ARTBX_BENCHMARK_STATISTICS(T, KERNEL)                                  \
+  BENCHMARK_TEMPLATE(BM_Statistics, T, KERNEL, false)                          \
+      ->RangeMultiplier(10)                                                    \
+      ->Range(min_samples, max_samples)                                        \
+      ->Unit(benchmark::kMicrosecond);                                         \
+  BENCHMARK_TEMPLATE(BM_Statistics, T, KERNEL, true)                           \
+      ->RangeMultiplier(10)                                                    \
+      ->Range(min_samples, max_streaming_samples)                              \
+      ->Unit(benchmark::kMicrosecond)
+
+ARTBX_BENCHMARK_STATISTICS(float, PerSample);
+ARTBX_BENCHMARK_STATISTICS(float, Batch);
+ARTBX_BENCHMARK_STATISTICS(double, PerSample);
+ARTBX_BENCHMARK_STATISTICS(double, Batch);
+ARTBX_BENCHMARK_STATISTICS(long double, PerSample);
+ARTBX_BENCHMARK_STATISTICS(long double, Batch);
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
+
+BENCHMARK_MAIN();
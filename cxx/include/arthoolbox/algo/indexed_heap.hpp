@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>  // max, min
+#include <cassert>    // assert
+#include <cstdint>    // uint32_t
+#include <cstdlib>    // std::size_t
+#include <functional> // less
+#include <limits>     // numeric_limits
+#include <vector>
+
+namespace arthoolbox {
+namespace algo {
+
+/**
+ * @brief Indexed D-ary min heap (priority queue) supporting decrease-key
+ *
+ * @tparam Key     The priority type
+ * @tparam Arity   The number of children per node (D)
+ * @tparam Compare Ordering of the keys, the 'smallest' key is on top
+ *
+ * @details
+ * Items are identified by a dense id (0, 1, 2...) and each item is at most
+ * once inside the heap: the heap position of each id is tracked, so that the
+ * key of an item already inside the heap can be updated in place
+ * (decrease-key) instead of pushing a duplicate.
+ *
+ * A D-ary heap (D = 4 by default) is shallower than a binary heap: sifting up
+ * (push/decrease) is cheaper, and the children of a node share a cache line.
+ *
+ * The largest size reached by the heap (high-water mark) is recorded.
+ */
+template <class Key, std::size_t Arity = 4, class Compare = std::less<Key>>
+class IndexedHeap {
+  static_assert(Arity >= 2, "The arity must be >= 2");
+
+public:
+  using id_type = std::uint32_t;
+
+  /**
+   * @brief Construct the heap
+   *
+   * @param[in] capacity The number of ids to reserve space for
+   * @param[in] compare  The key ordering
+   */
+  explicit IndexedHeap(const std::size_t capacity = 0,
+                       const Compare &compare = Compare())
+      : compare_(compare), high_water_mark_(0) {
+    reserve(capacity);
+  }
+
+  /**
+   * @brief Reserve space for the ids [0, capacity)
+   */
+  void reserve(const std::size_t capacity) {
+    heap_.reserve(capacity);
+    if (capacity > positions_.size()) {
+      keys_.resize(capacity);
+      positions_.resize(capacity, npos);
+    }
+  }
+
+  /**
+   * @return True when the heap is empty
+   */
+  bool empty() const noexcept { return heap_.empty(); }
+
+  /**
+   * @return The number of items inside the heap
+   */
+  std::size_t size() const noexcept { return heap_.size(); }
+
+  /**
+   * @return The largest size reached since the construction/the last call to
+   * clear()
+   */
+  std::size_t getHighWaterMark() const noexcept { return high_water_mark_; }
+
+  /**
+   * @return True if the item id is inside the heap
+   */
+  bool contains(const id_type id) const noexcept {
+    return (id < positions_.size()) and (positions_[id] != npos);
+  }
+
+  /**
+   * @return The key of an item inside the heap
+   */
+  const Key &getKey(const id_type id) const noexcept {
+    assert(contains(id) && "The item must be inside the heap");
+    return keys_[id];
+  }
+
+  /**
+   * @return The id of the item on top (smallest key)
+   */
+  id_type top() const noexcept {
+    assert(not empty() && "The heap must not be empty");
+    return heap_.front();
+  }
+
+  /**
+   * @brief Remove all the items (the memory is kept)
+   */
+  void clear() noexcept {
+    for (const auto id : heap_)
+      positions_[id] = npos;
+    heap_.clear();
+    high_water_mark_ = 0;
+  }
+
+  /**
+   * @brief Insert an item not already inside the heap
+   *
+   * @param[in] id  The item id
+   * @param[in] key The item priority
+   */
+  void push(const id_type id, const Key &key) {
+    assert(not contains(id) && "The item is already inside the heap");
+    if (id >= positions_.size())
+      reserve(std::max<std::size_t>(id + 1, 2 * positions_.size()));
+
+    keys_[id] = key;
+    heap_.push_back(id);
+    if (heap_.size() > high_water_mark_)
+      high_water_mark_ = heap_.size();
+
+    siftUp(heap_.size() - 1);
+  }
+
+  /**
+   * @brief Lower the key of an item inside the heap
+   *
+   * @param[in] id  The item id
+   * @param[in] key The new item priority (must not be greater than the
+   *                current one)
+   */
+  void decrease(const id_type id, const Key &key) noexcept {
+    assert(contains(id) && "The item must be inside the heap");
+    assert(not compare_(keys_[id], key) && "The key can only decrease");
+    keys_[id] = key;
+    siftUp(positions_[id]);
+  }
+
+  /**
+   * @brief Insert an item, or lower its key if already inside the heap
+   *
+   * @return True if the item has been inserted
+   */
+  bool pushOrDecrease(const id_type id, const Key &key) {
+    if (contains(id)) {
+      decrease(id, key);
+      return false;
+    }
+
+    push(id, key);
+    return true;
+  }
+
+  /**
+   * @brief Remove the item on top (smallest key)
+   *
+   * @return The id of the item removed
+   */
+  id_type pop() noexcept {
+    assert(not empty() && "The heap must not be empty");
+    const auto id = heap_.front();
+    positions_[id] = npos;
+
+    const auto last = heap_.back();
+    heap_.pop_back();
+    if (not heap_.empty()) {
+      heap_.front() = last;
+      positions_[last] = 0;
+      siftDown(0);
+    }
+
+    return id;
+  }
+
+private:
+  static constexpr id_type npos = std::numeric_limits<id_type>::max();
+
+  void place(const std::size_t position, const id_type id) noexcept {
+    heap_[position] = id;
+    positions_[id] = static_cast<id_type>(position);
+  }
+
+  void siftUp(std::size_t position) noexcept {
+    const auto id = heap_[position];
+    while (position > 0) {
+      const auto parent = (position - 1) / Arity;
+      if (not compare_(keys_[id], keys_[heap_[parent]]))
+        break;
+
+      place(position, heap_[parent]);
+      position = parent;
+    }
+    place(position, id);
+  }
+
+  void siftDown(std::size_t position) noexcept {
+    const auto id = heap_[position];
+    const auto size = heap_.size();
+    while (true) {
+      const auto first_child = position * Arity + 1;
+      if (first_child >= size)
+        break;
+
+      // Smallest child
+      auto child = first_child;
+      const auto last_child = std::min(first_child + Arity, size);
+      for (auto other = first_child + 1; other < last_child; ++other)
+        if (compare_(keys_[heap_[other]], keys_[heap_[child]]))
+          child = other;
+
+      if (not compare_(keys_[heap_[child]], keys_[id]))
+        break;
+
+      place(position, heap_[child]);
+      position = child;
+    }
+    place(position, id);
+  }
+
+  Compare compare_;                /*!< Hold the key ordering */
+  std::size_t high_water_mark_;    /*!< Hold the largest size reached */
+  std::vector<id_type> heap_;      /*!< Hold the ids, in heap order */
+  std::vector<Key> keys_;          /*!< Hold the key of each id */
+  std::vector<id_type> positions_; /*!< Hold the heap position of each id */
+};
+
+} // namespace algo
+} // namespace arthoolbox
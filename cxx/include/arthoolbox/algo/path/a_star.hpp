@@ -1,49 +1,98 @@
+#pragma once
 
-#include <functional> // functors
-#include <limits>     // numeric_limits -> inf
-#include <queue>      // priority_queue
+#include <functional>  // functors
+#include <limits>      // numeric_limits -> inf
+#include <queue>       // priority_queue
+#include <tuple>       // get, tie
+#include <type_traits> // enable_if, is_invocable_r, void_t
 #include <unordered_map>
 #include <unordered_set>
+#include <utility> // declval, pair
 #include <vector>
 
 namespace arthoolbox {
 namespace algo {
 namespace path {
 
+namespace details {
+
 /**
- * @brief Compute the shortest path using A* algorithm
- *
- * @tparam T     The type use as coordinates inside the map
- * @tparam Hash  Use to hash a T
- * @tparam Equal Use to compare 2 T (equals)
- *
- * @param[in] from_position      The starting node
- * @param[in] to_position        The targetted node
- * @param[in] heuristicFrom      A function called to compute the heuristic from
- *                               one node
- * @param[in] getWeightedNeighOf A function use to retreive valid weighted
- *                               neighbors list around a node
- *
- * @return std::vector of position with .back() being the INITIAL position
- *
- * @details
- * This function try to find the shortest path, from one point to an other using
- * the A* algorithm.
- * It is completly unaware of the map and must be feed with functions (lambda,
- * std::functions..) that it will call to be able to compute the heuristics
- * score from 1 node and retreive all valid neighbors, with their associated
- * distance to 1 node.
- *
- * @warning
- * The output vector is 'reversed' (i.e. the path from start to finish must be
- * read from .back() to front / reverse iterated)
+ * @brief Tells if a neighbor (element returned by a neighbor provider) is a
+ * weighted neighbor, i.e. a (position, distance) pair/tuple, instead of a
+ * position (distance = 1)
  */
-template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
-std::vector<T>
-aStarShortestPath(const T &from_position, const T &to_position,
-                  std::function<double(const T &)> heuristicFrom,
-                  std::function<std::vector<std::pair<T, double>>(const T &)>
-                      getWeightedNeighOf) {
+template <class T, class Neighbor, class = void>
+struct is_weighted_neighbor : std::false_type {};
+
+template <class T, class Neighbor>
+struct is_weighted_neighbor<
+    T, Neighbor,
+    std::enable_if_t<
+        not std::is_convertible<const Neighbor &, const T &>::value and
+        std::is_convertible<decltype(std::get<0>(std::declval<Neighbor>())),
+                            const T &>::value and
+        std::is_convertible<decltype(std::get<1>(std::declval<Neighbor>())),
+                            double>::value>> : std::true_type {};
+
+/**
+ * @brief Tells if Neighbor is a valid neighbor of a position T (a position or
+ * a weighted neighbor)
+ */
+template <class T, class Neighbor>
+using is_neighbor = std::integral_constant<
+    bool, std::is_convertible<const Neighbor &, const T &>::value or
+              is_weighted_neighbor<T, Neighbor>::value>;
+
+/**
+ * @brief Tells if NeighborProvider, called with a position T, returns a range
+ * of neighbors
+ */
+template <class T, class NeighborProvider, class = void>
+struct is_neighbor_provider : std::false_type {};
+
+template <class T, class NeighborProvider>
+struct is_neighbor_provider<
+    T, NeighborProvider,
+    std::enable_if_t<is_neighbor<
+        T, std::decay_t<decltype(*std::begin(std::declval<std::invoke_result_t<
+                                     NeighborProvider &, const T &>>()))>>::
+                         value>> : std::true_type {};
+
+/**
+ * @brief The 'graph concept' of the A* search: the heuristic is callable as
+ * double(const T&) and the neighbor provider returns a range of neighbors
+ */
+template <class T, class Heuristic, class NeighborProvider>
+using is_a_star_graph = std::integral_constant<
+    bool, std::is_invocable_r<double, Heuristic &, const T &>::value and
+              is_neighbor_provider<T, NeighborProvider>::value>;
+
+/// Position of a neighbor (weighted or not)
+template <class T, class Neighbor>
+constexpr decltype(auto) neighborPosition(const Neighbor &neighbor) noexcept {
+  if constexpr (is_weighted_neighbor<T, Neighbor>::value)
+    return std::get<0>(neighbor);
+  else
+    return neighbor;
+}
+
+/// Distance to a neighbor (1 when not weighted)
+template <class T, class Neighbor>
+constexpr double neighborDistance(const Neighbor &neighbor) noexcept {
+  if constexpr (is_weighted_neighbor<T, Neighbor>::value)
+    return std::get<1>(neighbor);
+  else
+    return 1.;
+}
+
+/**
+ * @brief Implementation of aStarShortestPath, for any callables
+ */
+template <class T, class Hash, class Equal, class Heuristic,
+          class NeighborProvider>
+std::vector<T> aStarShortestPath(const T &from_position, const T &to_position,
+                                 Heuristic &heuristicFrom,
+                                 NeighborProvider &getNeighOf) {
 
   typedef std::pair<T, double> node_t;
 
@@ -76,7 +125,10 @@ aStarShortestPath(const T &from_position, const T &to_position,
     std::tie(current_position, current_f_score) = node_heap.top();
     node_heap.pop();
 
-    visited_position.insert(current_position);
+    // Stale entry: the node has been pushed again (with a better score) and
+    // already expanded
+    if (not visited_position.insert(current_position).second)
+      continue;
 
     if (position_are_equals(current_position, to_position)) {
 
@@ -94,14 +146,13 @@ aStarShortestPath(const T &from_position, const T &to_position,
 
     } else {
       // explore
-      for (const auto &neighbour_info : getWeightedNeighOf(current_position)) {
-        T neighbour_position;
-        double neighbour_distance;
-
-        std::tie(neighbour_position, neighbour_distance) = neighbour_info;
+      const double current_g_score = g_score_map[current_position];
+      for (const auto &neighbour_info : getNeighOf(current_position)) {
+        const T &neighbour_position = neighborPosition<T>(neighbour_info);
 
         // Compute the possible new score from this node to the neighbor
-        double new_g_score = g_score_map[current_position] + neighbour_distance;
+        double new_g_score =
+            current_g_score + neighborDistance<T>(neighbour_info);
 
         auto neighbour_g_score_it = g_score_map.find(neighbour_position);
 
@@ -113,7 +164,7 @@ aStarShortestPath(const T &from_position, const T &to_position,
         if (new_g_score < neighbour_g_score_it->second) {
           // Better g_score than neighbour
           came_from[neighbour_position] = current_position;
-          g_score_map[neighbour_position] = new_g_score;
+          neighbour_g_score_it->second = new_g_score;
 
           if (visited_position.find(neighbour_position) ==
               visited_position.end()) {
@@ -128,89 +179,90 @@ aStarShortestPath(const T &from_position, const T &to_position,
   return output_path;
 }
 
+} // namespace details
+
+/**
+ * @brief Compute the shortest path using A* algorithm
+ *
+ * @tparam T     The type use as coordinates inside the map
+ * @tparam Hash  Use to hash a T
+ * @tparam Equal Use to compare 2 T (equals)
+ *
+ * @param[in] from_position      The starting node
+ * @param[in] to_position        The targetted node
+ * @param[in] heuristicFrom      A function called to compute the heuristic from
+ *                               one node
+ * @param[in] getWeightedNeighOf A function use to retreive valid weighted
+ *                               neighbors list around a node
+ *
+ * @return std::vector of position with .back() being the INITIAL position
+ *
+ * @details
+ * This function try to find the shortest path, from one point to an other using
+ * the A* algorithm.
+ * It is completly unaware of the map and must be feed with functions (lambda,
+ * std::functions..) that it will call to be able to compute the heuristics
+ * score from 1 node and retreive all valid neighbors, with their associated
+ * distance to 1 node.
+ *
+ * @warning
+ * The output vector is 'reversed' (i.e. the path from start to finish must be
+ * read from .back() to front / reverse iterated)
+ */
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+std::vector<T>
+aStarShortestPath(const T &from_position, const T &to_position,
+                  std::function<double(const T &)> heuristicFrom,
+                  std::function<std::vector<std::pair<T, double>>(const T &)>
+                      getWeightedNeighOf) {
+  return details::aStarShortestPath<T, Hash, Equal>(
+      from_position, to_position, heuristicFrom, getWeightedNeighOf);
+}
+
 // Specialised overload with Neighbors distance = 1
 template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
 std::vector<T>
 aStarShortestPath(const T &from_position, const T &to_position,
                   std::function<double(const T &)> heuristicFrom,
                   std::function<std::vector<T>(const T &)> getNeighOf) {
+  return details::aStarShortestPath<T, Hash, Equal>(from_position, to_position,
+                                                    heuristicFrom, getNeighOf);
+}
 
-  typedef std::pair<T, double> node_t;
-
-  auto compare_f_score = [](const node_t &lhs, const node_t &rhs) {
-    return lhs.second > rhs.second;
-  };
-
-  typedef std::priority_queue<node_t, std::vector<node_t>,
-                              decltype(compare_f_score)>
-      node_heap_t;
-
-  typedef std::unordered_set<T, Hash, Equal> visited_pos_set_t;
-  typedef std::unordered_map<T, double, Hash, Equal> score_map_t;
-  typedef std::unordered_map<T, T, Hash, Equal> path_map_t;
-
-  std::vector<T> output_path;
-  node_heap_t node_heap(compare_f_score);
-  visited_pos_set_t visited_position(0);
-  score_map_t g_score_map;
-  path_map_t came_from;
-  auto position_are_equals = Equal();
-
-  node_heap.emplace(from_position, heuristicFrom(from_position));
-  g_score_map.emplace(from_position, 0);
-
-  while (!node_heap.empty()) {
-    T current_position;
-    double current_f_score;
-
-    std::tie(current_position, current_f_score) = node_heap.top();
-    node_heap.pop();
-
-    visited_position.insert(current_position);
-
-    if (position_are_equals(current_position, to_position)) {
-
-      // FIXME: Find the size before push_back ?
-
-      // Found -> reconstruct path
-      output_path.push_back(current_position);
-      auto pos_it = came_from.find(current_position);
-      while (pos_it != came_from.end()) {
-        output_path.push_back(pos_it->second);
-        pos_it = came_from.find(pos_it->second);
-      }
-      output_path.shrink_to_fit();
-      break;
-
-    } else {
-      // explore
-      for (const auto &neighbour_position : getNeighOf(current_position)) {
-
-        // Compute the possible new score from this node to the neighbor
-        double new_g_score = g_score_map[current_position] + 1.;
-        auto neighbour_g_score_it = g_score_map.find(neighbour_position);
-
-        // Get the neighbour g_score
-        if (neighbour_g_score_it == g_score_map.end())
-          std::tie(neighbour_g_score_it, std::ignore) = g_score_map.insert(
-              {neighbour_position, std::numeric_limits<double>::infinity()});
-
-        if (new_g_score < neighbour_g_score_it->second) {
-          // Better g_score than neighbour
-          came_from[neighbour_position] = current_position;
-          g_score_map[neighbour_position] = new_g_score;
-
-          if (visited_position.find(neighbour_position) ==
-              visited_position.end()) {
-            node_heap.emplace(neighbour_position,
-                              new_g_score + heuristicFrom(neighbour_position));
-          }
-        }
-      }
-    }
-  }
-
-  return output_path;
+/**
+ * @brief Compute the shortest path using A* algorithm, calling the heuristic
+ * and the neighbor provider directly (no std::function type erasure), so they
+ * can be inlined
+ *
+ * @tparam T                The type use as coordinates inside the map
+ * @tparam Hash             Use to hash a T
+ * @tparam Equal            Use to compare 2 T (equals)
+ * @tparam Heuristic        Callable as double(const T&)
+ * @tparam NeighborProvider Callable as R(const T&), R being a range of
+ *                          neighbors: either positions T (distance = 1) or
+ *                          weighted neighbors (std::pair<T, double>, tuple...)
+ *
+ * @param[in] from_position The starting node
+ * @param[in] to_position   The targetted node
+ * @param[in] heuristicFrom Called to compute the heuristic from one node
+ * @param[in] getNeighOf    Called to retreive the valid neighbors of a node
+ *
+ * @return std::vector of position with .back() being the INITIAL position
+ *
+ * @warning
+ * The output vector is 'reversed' (i.e. the path from start to finish must be
+ * read from .back() to front / reverse iterated)
+ */
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>,
+          class Heuristic, class NeighborProvider,
+          std::enable_if_t<
+              details::is_a_star_graph<T, Heuristic, NeighborProvider>::value,
+              bool> = true>
+std::vector<T> aStarShortestPath(const T &from_position, const T &to_position,
+                                 Heuristic &&heuristicFrom,
+                                 NeighborProvider &&getNeighOf) {
+  return details::aStarShortestPath<T, Hash, Equal>(from_position, to_position,
+                                                    heuristicFrom, getNeighOf);
 }
 
 } // namespace path
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>   // fill, push_heap, pop_heap, reverse
+#include <array>       // array
+#include <cassert>     // assert
+#include <cstdint>     // uint8_t, uint32_t, uint64_t
+#include <cstdlib>     // std::size_t
+#include <limits>      // numeric_limits
+#include <type_traits> // is_invocable_r
+#include <vector>
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+
+/**
+ * @brief A* engine dedicated to dense Dim dimensional grids (2D/3D occupancy
+ * maps...), with unit moves along each axis (4 neighbors in 2D, 6 in 3D)
+ *
+ * @tparam Dim The number of dimensions of the grid
+ *
+ * @details
+ * Cells are identified by their linear index (x + y * X + z * X * Y...): the
+ * state of each cell (g score, move from its parent, open/closed flags) is
+ * stored into flat arrays, allocated once and reused across queries. No hash
+ * lookup and no allocation happens while searching (apart from the open list
+ * growth).
+ *
+ * Instead of clearing the arrays between queries, each cell holds the
+ * generation (query number) it was last touched by: a cell from an older
+ * generation is unvisited.
+ *
+ * The heuristic is the Manhattan distance, which is consistent for unit
+ * moves: a closed cell is never re-opened and stale open list entries are
+ * skipped. Ties on the f score are broken toward the highest g score (the
+ * cells closest to the goal), limiting the expansions on open areas.
+ *
+ * @warning This class is not thread safe, use one engine per thread.
+ */
+template <std::size_t Dim> class GridAStar {
+  static_assert(Dim > 0, "The dimension must be > 0");
+
+public:
+  using cell_type = std::array<std::size_t, Dim>;
+
+  /**
+   * @brief Construct the engine for a grid
+   *
+   * @param[in] extents The size of the grid along each dimension
+   */
+  explicit GridAStar(const cell_type &extents)
+      : extents_(extents), number_of_cells_(1), generation_(0),
+        expansions_(0) {
+    for (std::size_t d = 0; d < Dim; ++d) {
+      strides_[d] = number_of_cells_;
+      number_of_cells_ *= extents_[d];
+    }
+
+    assert(number_of_cells_ <= std::numeric_limits<std::uint32_t>::max() &&
+           "Cells index must fit into 32 bits");
+
+    g_scores_.resize(number_of_cells_);
+    parent_moves_.resize(number_of_cells_);
+    states_.resize(number_of_cells_, 0);
+  }
+
+  /**
+   * @return The size of the grid along each dimension
+   */
+  const cell_type &getExtents() const noexcept { return extents_; }
+
+  /**
+   * @return The number of cells of the grid
+   */
+  std::size_t getNumberOfCells() const noexcept { return number_of_cells_; }
+
+  /**
+   * @return The number of cells expanded by the last search
+   */
+  std::size_t getNumberOfExpansions() const noexcept { return expansions_; }
+
+  /**
+   * @return The linear index of a cell
+   */
+  std::size_t toIndex(const cell_type &cell) const noexcept {
+    std::size_t index = 0;
+    for (std::size_t d = 0; d < Dim; ++d)
+      index += cell[d] * strides_[d];
+    return index;
+  }
+
+  /**
+   * @return The cell of a linear index
+   */
+  cell_type toCell(std::size_t index) const noexcept {
+    cell_type cell;
+    for (std::size_t d = 0; d < Dim; ++d) {
+      cell[d] = index % extents_[d];
+      index /= extents_[d];
+    }
+    return cell;
+  }
+
+  /**
+   * @brief Compute the shortest path between 2 cells
+   *
+   * @tparam IsFree Callable as bool(std::size_t index), telling if the cell
+   *                at the given linear index can be crossed
+   *
+   * @param[in]  from   The starting cell
+   * @param[in]  to     The targetted cell
+   * @param[in]  isFree Tells if a cell can be crossed
+   * @param[out] path   Filled with the path indexes, from .back() being the
+   *                    INITIAL position to .front() being the target (same
+   *                    order than aStarShortestPath). Cleared when no path
+   *                    exists.
+   *
+   * @return True if a path has been found
+   */
+  template <class IsFree>
+  bool shortestPath(const cell_type &from, const cell_type &to,
+                    IsFree &&isFree, std::vector<std::size_t> &path) {
+    static_assert(std::is_invocable_r<bool, IsFree &, std::size_t>::value,
+                  "IsFree must be callable as bool(std::size_t)");
+
+    path.clear();
+    open_list_.clear();
+    expansions_ = 0;
+    nextGeneration();
+
+    const auto start = toIndex(from);
+    const auto goal = toIndex(to);
+
+    open(start, 0, 0, heuristic(from, to));
+
+    while (not open_list_.empty()) {
+      std::pop_heap(open_list_.begin(), open_list_.end(), compare);
+      const auto current = open_list_.back().index;
+      open_list_.pop_back();
+
+      // Stale entry: already closed with a better (or equal) score
+      if (states_[current] == closedState())
+        continue;
+      states_[current] = closedState();
+
+      if (current == goal) {
+        reconstructPath(start, goal, path);
+        return true;
+      }
+
+      ++expansions_;
+      const auto cell = toCell(current);
+      const auto g_score = g_scores_[current] + 1;
+
+      for (std::size_t d = 0; d < Dim; ++d) {
+        if (cell[d] > 0)
+          relax(current - strides_[d], 2 * d, g_score, cell, d, -1, to,
+                isFree);
+
+        if (cell[d] + 1 < extents_[d])
+          relax(current + strides_[d], 2 * d + 1, g_score, cell, d, +1, to,
+                isFree);
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Compute the shortest path between 2 cells
+   *
+   * @return The path cells, .back() being the INITIAL position (empty when no
+   * path exists)
+   */
+  template <class IsFree>
+  std::vector<cell_type> shortestPath(const cell_type &from,
+                                      const cell_type &to, IsFree &&isFree) {
+    std::vector<std::size_t> indexes;
+    std::vector<cell_type> path;
+    if (shortestPath(from, to, isFree, indexes)) {
+      path.reserve(indexes.size());
+      for (const auto index : indexes)
+        path.push_back(toCell(index));
+    }
+    return path;
+  }
+
+private:
+  /// Entry of the open list, ordered by f score then highest g score
+  struct Node {
+    std::uint64_t key;
+    std::uint32_t index;
+  };
+
+  static bool compare(const Node &lhs, const Node &rhs) noexcept {
+    return lhs.key > rhs.key;
+  }
+
+  static std::uint64_t keyOf(const std::uint32_t g_score,
+                             const std::uint32_t f_score) noexcept {
+    return (static_cast<std::uint64_t>(f_score) << 32) |
+           (std::numeric_limits<std::uint32_t>::max() - g_score);
+  }
+
+  static std::uint32_t heuristic(const cell_type &cell,
+                                 const cell_type &goal) noexcept {
+    std::size_t distance = 0;
+    for (std::size_t d = 0; d < Dim; ++d)
+      distance += (cell[d] > goal[d]) ? cell[d] - goal[d] : goal[d] - cell[d];
+    return static_cast<std::uint32_t>(distance);
+  }
+
+  /// States: open = 2 * generation, closed = 2 * generation + 1, anything
+  /// else is unvisited
+  std::uint32_t openState() const noexcept { return 2 * generation_; }
+  std::uint32_t closedState() const noexcept { return 2 * generation_ + 1; }
+
+  void nextGeneration() {
+    if (++generation_ > std::numeric_limits<std::uint32_t>::max() / 2 - 1) {
+      std::fill(states_.begin(), states_.end(), 0);
+      generation_ = 1;
+    }
+  }
+
+  void open(const std::size_t index, const std::uint8_t move,
+            const std::uint32_t g_score, const std::uint32_t h_score) {
+    states_[index] = openState();
+    g_scores_[index] = g_score;
+    parent_moves_[index] = move;
+    open_list_.push_back(
+        {keyOf(g_score, g_score + h_score), static_cast<std::uint32_t>(index)});
+    std::push_heap(open_list_.begin(), open_list_.end(), compare);
+  }
+
+  template <class IsFree>
+  void relax(const std::size_t neighbor, const std::uint8_t move,
+             const std::uint32_t g_score, cell_type cell, const std::size_t d,
+             const int step, const cell_type &goal, IsFree &isFree) {
+    const auto state = states_[neighbor];
+    if (state == closedState())
+      return;
+
+    if ((state == openState()) and (g_scores_[neighbor] <= g_score))
+      return;
+
+    if (not isFree(neighbor))
+      return;
+
+    cell[d] += step;
+    open(neighbor, move, g_score, heuristic(cell, goal));
+  }
+
+  void reconstructPath(const std::size_t start, const std::size_t goal,
+                       std::vector<std::size_t> &path) const {
+    path.reserve(g_scores_[goal] + 1);
+    for (auto index = goal; index != start;) {
+      path.push_back(index);
+      const auto move = parent_moves_[index];
+      const auto stride = strides_[move / 2];
+      index = (move % 2) ? index - stride : index + stride;
+    }
+    path.push_back(start);
+  }
+
+  cell_type extents_;                      /*!< Hold the size of each dim */
+  cell_type strides_;                      /*!< Hold the stride of each dim */
+  std::size_t number_of_cells_;            /*!< Hold the number of cells */
+  std::uint32_t generation_;               /*!< Hold the query generation */
+  std::size_t expansions_;                 /*!< Hold the last expansions */
+  std::vector<std::uint32_t> g_scores_;    /*!< Hold the g score per cell */
+  std::vector<std::uint8_t> parent_moves_; /*!< Hold the move from parent */
+  std::vector<std::uint32_t> states_;      /*!< Hold the open/closed state */
+  std::vector<Node> open_list_;            /*!< Hold the open list heap */
+};
+
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
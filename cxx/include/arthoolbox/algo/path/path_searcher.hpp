@@ -0,0 +1,489 @@
+#pragma once
+
+#include <algorithm>   // max
+#include <cstdint>     // uint32_t, uint64_t
+#include <cmath>       // isnan
+#include <cstdlib>     // std::size_t
+#include <functional>  // hash, equal_to
+#include <limits>      // numeric_limits
+#include <type_traits> // enable_if_t
+#include <utility>     // pair
+#include <vector>
+
+#include "arthoolbox/algo/indexed_heap.hpp"
+#include "arthoolbox/algo/path/a_star.hpp"
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+
+/**
+ * @brief A* search workspace, reusable across queries on the same graph
+ *
+ * @tparam T     The type use as coordinates inside the map
+ * @tparam Hash  Use to hash a T
+ * @tparam Equal Use to compare 2 T (equals)
+ *
+ * @details
+ * aStarShortestPath creates (and destroys) its heap, score maps and visited
+ * set on each call. A PathSearcher owns them instead:
+ * - The nodes reached by a query (position, g score, parent) are stored into
+ *   flat arrays, indexed by the order they have been reached;
+ * - An open addressing table maps a position to its node. Each slot holds
+ *   the generation (query number) that filled it: starting a new query only
+ *   increments the generation, the table is never cleared;
+ * - The open list (an IndexedHeap of the node ids) and the output path keep
+ *   their capacity.
+ *
+ * A node reached again with a better g score has its f score decreased in
+ * place inside the open list: the open list never contains stale duplicates
+ * and a node is expanded once (for a consistent heuristic).
+ *
+ * Once the workspace has grown to the size of the queries, searching doesn't
+ * perform any allocation (provided the neighbor provider doesn't allocate,
+ * e.g. by returning a reference to a reused container).
+ *
+ * Expanded nodes reached with a better g score are re-opened, so the path is
+ * the shortest one for any admissible heuristic.
+ *
+ * bidirectionalShortestPath searches from both ends at once and meets in the
+ * middle, each side exploring about half the radius explored by shortestPath.
+ * This only reduces the work inside open regions: along corridors, it expands
+ * as many nodes as shortestPath (see bidirectionalShortestPath).
+ *
+ * @warning This class is not thread safe, use one searcher per thread.
+ */
+template <class T, class Hash = std::hash<T>, class Equal = std::equal_to<T>>
+class PathSearcher {
+public:
+  /**
+   * @brief Construct the searcher
+   *
+   * @param[in] capacity The number of nodes to reserve space for
+   * @param[in] hash     The hash function used
+   * @param[in] equal    The equality comparison used
+   */
+  explicit PathSearcher(const std::size_t capacity = 0,
+                        const Hash &hash = Hash(), const Equal &equal = Equal())
+      : hash_(hash), equal_(equal), generation_(0), shift_(64),
+        number_of_nodes_(0), expansions_(0) {
+    reserve(capacity);
+  }
+
+  /**
+   * @brief Make sure queries reaching up to capacity nodes don't allocate
+   *
+   * @param[in] capacity The number of nodes
+   *
+   * @note The reverse search state is only allocated by the first
+   *       bidirectionalShortestPath query
+   */
+  void reserve(const std::size_t capacity) {
+    if (capacity > positions_.size())
+      resizeNodes(capacity);
+    open_list_.reserve(capacity);
+
+    std::size_t slots = min_slots;
+    while (slots < 2 * capacity)
+      slots *= 2;
+
+    if (slots > slots_.size())
+      rehash(slots);
+  }
+
+  /**
+   * @return The number of nodes reached by the last query
+   */
+  std::size_t getNumberOfNodes() const noexcept { return number_of_nodes_; }
+
+  /**
+   * @return The number of nodes expanded by the last query
+   */
+  std::size_t getNumberOfExpansions() const noexcept { return expansions_; }
+
+  /**
+   * @return The largest size reached by the open list during the last query
+   *         (summed over both open lists for a bidirectional query)
+   */
+  std::size_t getOpenListHighWaterMark() const noexcept {
+    return open_list_.getHighWaterMark() +
+           reverse_open_list_.getHighWaterMark();
+  }
+
+  /**
+   * @brief Compute the shortest path using A* algorithm
+   *
+   * @tparam Heuristic        Callable as double(const T&)
+   * @tparam NeighborProvider Callable as R(const T&), R being a range of
+   *                          neighbors (positions or weighted neighbors, see
+   *                          aStarShortestPath)
+   *
+   * @param[in]  from_position The starting node
+   * @param[in]  to_position   The targetted node
+   * @param[in]  heuristicFrom Called to compute the heuristic from one node
+   * @param[in]  getNeighOf    Called to retreive the neighbors of a node
+   * @param[out] path          Filled with the path, .back() being the INITIAL
+   *                           position (cleared when no path exists)
+   *
+   * @return True if a path has been found
+   */
+  template <class Heuristic, class NeighborProvider,
+            std::enable_if_t<details::is_a_star_graph<
+                                 T, Heuristic, NeighborProvider>::value,
+                             bool> = true>
+  bool shortestPath(const T &from_position, const T &to_position,
+                    Heuristic &&heuristicFrom, NeighborProvider &&getNeighOf,
+                    std::vector<T> &path) {
+    startQuery(path);
+
+    const auto start = findOrInsert(from_position);
+    g_scores_[start] = 0;
+    open_list_.push(start, heuristicFrom(from_position));
+
+    while (not open_list_.empty()) {
+      const auto current = open_list_.pop();
+
+      if (equal_(positions_[current], to_position)) {
+        for (auto node = current; node != no_parent; node = parents_[node])
+          path.push_back(positions_[node]);
+        return true;
+      }
+
+      ++expansions_;
+      const double current_g_score = g_scores_[current];
+      for (const auto &neighbour_info : getNeighOf(positions_[current])) {
+        const T &neighbour_position =
+            details::neighborPosition<T>(neighbour_info);
+        const double new_g_score =
+            current_g_score + details::neighborDistance<T>(neighbour_info);
+
+        const auto neighbour = findOrInsert(neighbour_position);
+        if (new_g_score < g_scores_[neighbour]) {
+          g_scores_[neighbour] = new_g_score;
+          parents_[neighbour] = current;
+
+          // Decrease-key when already opened, (re-)open it otherwise
+          open_list_.pushOrDecrease(
+              neighbour, new_g_score + heuristicFrom(neighbour_position));
+        }
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Compute the shortest path using A* algorithm
+   *
+   * @return std::vector of position with .back() being the INITIAL position
+   */
+  template <class Heuristic, class NeighborProvider,
+            std::enable_if_t<details::is_a_star_graph<
+                                 T, Heuristic, NeighborProvider>::value,
+                             bool> = true>
+  std::vector<T> shortestPath(const T &from_position, const T &to_position,
+                              Heuristic &&heuristicFrom,
+                              NeighborProvider &&getNeighOf) {
+    std::vector<T> path;
+    shortestPath(from_position, to_position, heuristicFrom, getNeighOf, path);
+    return path;
+  }
+
+  /**
+   * @brief Compute the shortest path using bidirectional A* algorithm
+   *
+   * @tparam HeuristicFrom           Callable as double(const T&)
+   * @tparam HeuristicTo             Callable as double(const T&)
+   * @tparam NeighborProvider        Callable as R(const T&), R being a range
+   *                                 of neighbors (positions or weighted
+   *                                 neighbors, see aStarShortestPath)
+   * @tparam ReverseNeighborProvider Same as NeighborProvider
+   *
+   * @param[in]  from_position     The starting node
+   * @param[in]  to_position       The targetted node
+   * @param[in]  heuristicFrom     Estimate the distance from a node to
+   *                               to_position
+   * @param[in]  heuristicTo       Estimate the distance from from_position to
+   *                               a node
+   * @param[in]  getNeighOf        Called to retreive the neighbors of a node
+   *                               (the nodes reachable from it)
+   * @param[in]  getReverseNeighOf Called to retreive the reverse neighbors of
+   *                               a node (the nodes it can be reached from,
+   *                               with the distance of that edge). For an
+   *                               undirected graph, this is getNeighOf
+   * @param[out] path              Filled with the path, .back() being the
+   *                               INITIAL position (cleared when no path
+   *                               exists)
+   *
+   * @return True if a path has been found
+   *
+   * @details
+   * The forward search (from from_position) and the reverse search (from
+   * to_position) use the average potential p(n) = (heuristicFrom(n) -
+   * heuristicTo(n)) / 2, respectively +p and -p. Both are consistent when
+   * the heuristics are, so each side behaves like Dijkstra on the same
+   * reduced graph and the search stops as soon as the sum of both open lists
+   * top f scores reaches the best meeting distance found so far. The side with
+   * the smallest open list is expanded first.
+   *
+   * Halving the radius pays off when the explored area grows faster than the
+   * radius, i.e. inside open 2D/3D regions with a weak heuristic (about half
+   * the expansions of shortestPath without heuristic). The average potential
+   * is less informed than heuristicFrom: with an accurate heuristic, prefer
+   * shortestPath.
+   *
+   * It does NOT speed up searches along fixed width corridors: the explored
+   * area grows like the radius, so two half radius searches expand as many
+   * nodes as a single one (e.g. ~96k vs ~97k expansions through a 4096x32
+   * corridor). A front-to-end variant (each side using its own heuristic,
+   * stopping once max(top f scores) reaches the best meeting distance) has
+   * been measured too, and expands as many or more nodes.
+   *
+   * @warning Unlike shortestPath, the path is only guaranteed to be the
+   *          shortest one for CONSISTENT heuristics
+   */
+  template <class HeuristicFrom, class HeuristicTo, class NeighborProvider,
+            class ReverseNeighborProvider,
+            std::enable_if_t<
+                details::is_a_star_graph<T, HeuristicFrom,
+                                         NeighborProvider>::value and
+                    details::is_a_star_graph<T, HeuristicTo,
+                                             ReverseNeighborProvider>::value,
+                bool> = true>
+  bool bidirectionalShortestPath(const T &from_position, const T &to_position,
+                                 HeuristicFrom &&heuristicFrom,
+                                 HeuristicTo &&heuristicTo,
+                                 NeighborProvider &&getNeighOf,
+                                 ReverseNeighborProvider &&getReverseNeighOf,
+                                 std::vector<T> &path) {
+    startQuery(path);
+
+    const auto potentialOf = [&](const node_id node) {
+      if (std::isnan(potentials_[node]))
+        potentials_[node] =
+            (heuristicFrom(positions_[node]) - heuristicTo(positions_[node])) /
+            2;
+      return potentials_[node];
+    };
+
+    const auto start = findOrInsertBidirectional(from_position);
+    g_scores_[start] = 0;
+    open_list_.push(start, potentialOf(start));
+
+    const auto goal = findOrInsertBidirectional(to_position);
+    reverse_g_scores_[goal] = 0;
+    reverse_open_list_.push(goal, -potentialOf(goal));
+
+    // Best path found so far, going through meeting_node
+    double best_distance = start == goal
+                               ? 0.
+                               : std::numeric_limits<double>::infinity();
+    node_id meeting_node = start == goal ? start : no_parent;
+
+    while (not open_list_.empty() and not reverse_open_list_.empty() and
+           (open_list_.getKey(open_list_.top()) +
+            reverse_open_list_.getKey(reverse_open_list_.top())) <
+               best_distance) {
+      ++expansions_;
+
+      if (open_list_.size() <= reverse_open_list_.size()) {
+        const auto current = open_list_.pop();
+        const double current_g_score = g_scores_[current];
+        for (const auto &neighbour_info : getNeighOf(positions_[current])) {
+          const double new_g_score =
+              current_g_score + details::neighborDistance<T>(neighbour_info);
+          const auto neighbour = findOrInsertBidirectional(
+              details::neighborPosition<T>(neighbour_info));
+          if (new_g_score < g_scores_[neighbour]) {
+            g_scores_[neighbour] = new_g_score;
+            parents_[neighbour] = current;
+            open_list_.pushOrDecrease(neighbour,
+                                      new_g_score + potentialOf(neighbour));
+
+            if (new_g_score + reverse_g_scores_[neighbour] < best_distance) {
+              best_distance = new_g_score + reverse_g_scores_[neighbour];
+              meeting_node = neighbour;
+            }
+          }
+        }
+      } else {
+        const auto current = reverse_open_list_.pop();
+        const double current_g_score = reverse_g_scores_[current];
+        for (const auto &neighbour_info :
+             getReverseNeighOf(positions_[current])) {
+          const double new_g_score =
+              current_g_score + details::neighborDistance<T>(neighbour_info);
+          const auto neighbour = findOrInsertBidirectional(
+              details::neighborPosition<T>(neighbour_info));
+          if (new_g_score < reverse_g_scores_[neighbour]) {
+            reverse_g_scores_[neighbour] = new_g_score;
+            reverse_parents_[neighbour] = current;
+            reverse_open_list_.pushOrDecrease(
+                neighbour, new_g_score - potentialOf(neighbour));
+
+            if (new_g_score + g_scores_[neighbour] < best_distance) {
+              best_distance = new_g_score + g_scores_[neighbour];
+              meeting_node = neighbour;
+            }
+          }
+        }
+      }
+    }
+
+    if (meeting_node == no_parent)
+      return false;
+
+    // to_position -> meeting node (excluded), then meeting node -> start
+    for (auto node = reverse_parents_[meeting_node]; node != no_parent;
+         node = reverse_parents_[node])
+      path.push_back(positions_[node]);
+    std::reverse(path.begin(), path.end());
+    for (auto node = meeting_node; node != no_parent; node = parents_[node])
+      path.push_back(positions_[node]);
+    return true;
+  }
+
+  /**
+   * @brief Compute the shortest path using bidirectional A* algorithm
+   *
+   * @return std::vector of position with .back() being the INITIAL position
+   */
+  template <class HeuristicFrom, class HeuristicTo, class NeighborProvider,
+            class ReverseNeighborProvider,
+            std::enable_if_t<
+                details::is_a_star_graph<T, HeuristicFrom,
+                                         NeighborProvider>::value and
+                    details::is_a_star_graph<T, HeuristicTo,
+                                             ReverseNeighborProvider>::value,
+                bool> = true>
+  std::vector<T>
+  bidirectionalShortestPath(const T &from_position, const T &to_position,
+                            HeuristicFrom &&heuristicFrom,
+                            HeuristicTo &&heuristicTo,
+                            NeighborProvider &&getNeighOf,
+                            ReverseNeighborProvider &&getReverseNeighOf) {
+    std::vector<T> path;
+    bidirectionalShortestPath(from_position, to_position, heuristicFrom,
+                              heuristicTo, getNeighOf, getReverseNeighOf,
+                              path);
+    return path;
+  }
+
+private:
+  using node_id = std::uint32_t;
+
+  static constexpr node_id no_parent = std::numeric_limits<node_id>::max();
+  static constexpr std::size_t min_slots = 16;
+
+  /// Slot of the position -> node table, valid for a single generation
+  struct Slot {
+    std::uint32_t generation;
+    node_id node;
+  };
+
+  std::size_t slotOf(const T &position) const noexcept {
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(hash_(position)) * 0x9E3779B97F4A7C15ull) >>
+        shift_);
+  }
+
+  void startQuery(std::vector<T> &path) {
+    path.clear();
+    open_list_.clear();
+    reverse_open_list_.clear();
+    number_of_nodes_ = 0;
+    expansions_ = 0;
+    nextGeneration();
+  }
+
+  void nextGeneration() {
+    if (++generation_ == std::numeric_limits<std::uint32_t>::max()) {
+      for (auto &slot : slots_)
+        slot.generation = 0;
+      generation_ = 1;
+    }
+  }
+
+  /// Find the node of a position, creating it (unreached) if needed
+  node_id findOrInsert(const T &position) {
+    if (2 * (number_of_nodes_ + 1) > slots_.size())
+      rehash(std::max(min_slots, 2 * slots_.size()));
+
+    auto slot = slotOf(position);
+    for (; slots_[slot].generation == generation_;
+         slot = (slot + 1) & (slots_.size() - 1))
+      if (equal_(positions_[slots_[slot].node], position))
+        return slots_[slot].node;
+
+    if (number_of_nodes_ == positions_.size())
+      resizeNodes(std::max(min_slots, 2 * positions_.size()));
+
+    const auto node = static_cast<node_id>(number_of_nodes_++);
+    positions_[node] = position;
+    g_scores_[node] = std::numeric_limits<double>::infinity();
+    parents_[node] = no_parent;
+    slots_[slot] = {generation_, node};
+    return node;
+  }
+
+  /// findOrInsert, also initializing the reverse search state of new nodes
+  node_id findOrInsertBidirectional(const T &position) {
+    const auto number_of_nodes = number_of_nodes_;
+    const auto node = findOrInsert(position);
+    if (number_of_nodes_ == number_of_nodes)
+      return node;
+
+    if (reverse_g_scores_.size() < positions_.size()) {
+      reverse_g_scores_.resize(positions_.size());
+      reverse_parents_.resize(positions_.size());
+      potentials_.resize(positions_.size());
+    }
+    reverse_g_scores_[node] = std::numeric_limits<double>::infinity();
+    reverse_parents_[node] = no_parent;
+    potentials_[node] = std::numeric_limits<double>::quiet_NaN();
+    return node;
+  }
+
+  void resizeNodes(const std::size_t capacity) {
+    positions_.resize(capacity);
+    g_scores_.resize(capacity);
+    parents_.resize(capacity);
+  }
+
+  /// Grow the table, re-inserting the nodes of the current generation
+  void rehash(const std::size_t number_of_slots) {
+    slots_.assign(number_of_slots, Slot{0, 0});
+    shift_ = 64;
+    for (auto slots = number_of_slots; slots > 1; slots /= 2)
+      --shift_;
+
+    for (node_id node = 0; node < number_of_nodes_; ++node) {
+      auto slot = slotOf(positions_[node]);
+      while (slots_[slot].generation == generation_)
+        slot = (slot + 1) & (slots_.size() - 1);
+      slots_[slot] = {generation_, node};
+    }
+  }
+
+  Hash hash_;                     /*!< Hold the hash function */
+  Equal equal_;                   /*!< Hold the equality comparison */
+  std::uint32_t generation_;      /*!< Hold the current query generation */
+  unsigned shift_;                /*!< Hold 64 - log2(number of slots) */
+  std::size_t number_of_nodes_;   /*!< Hold the number of nodes reached */
+  std::size_t expansions_;        /*!< Hold the last query expansions */
+  std::vector<Slot> slots_;       /*!< Hold the position -> node table */
+  std::vector<T> positions_;      /*!< Hold the position of each node */
+  std::vector<double> g_scores_;  /*!< Hold the g score of each node */
+  std::vector<node_id> parents_;  /*!< Hold the parent of each node */
+  IndexedHeap<double> open_list_; /*!< Hold the open list (node ids) */
+
+  // Reverse search (bidirectional queries only)
+  std::vector<double> reverse_g_scores_;  /*!< Hold the reverse g scores */
+  std::vector<node_id> reverse_parents_;  /*!< Hold the reverse parents */
+  std::vector<double> potentials_;        /*!< Hold the node potentials */
+  IndexedHeap<double> reverse_open_list_; /*!< Hold the reverse open list */
+};
+
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
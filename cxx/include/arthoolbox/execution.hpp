@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdlib> // std::size_t
+#include <thread>  // hardware_concurrency
+
+namespace arthoolbox {
+namespace execution {
+
+/**
+ * @brief Execution policy tag requesting a sequential execution on the calling
+ * thread
+ */
+struct sequenced_policy {};
+
+/**
+ * @brief Execution policy requesting a parallel execution, split across
+ * multiple threads
+ */
+struct parallel_policy {
+  /**
+   * @brief Get the number of threads that should be used
+   * @return std::size_t thread_count, or the hardware concurrency when
+   * thread_count is 0 (always >= 1)
+   */
+  std::size_t concurrency() const noexcept {
+    if (thread_count != 0)
+      return thread_count;
+
+    const auto hardware = std::thread::hardware_concurrency();
+    return hardware != 0 ? hardware : 1;
+  }
+
+  std::size_t thread_count = 0; /*!< Max number of threads (0 = hardware) */
+};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+} // namespace execution
+} // namespace arthoolbox
@@ -23,7 +23,7 @@ class strided_iterator {
 
  protected:
   _Iterator _current;
-  const difference_type _stride;
+  difference_type _stride;
 
  public:
   strided_iterator() = delete;
@@ -35,7 +35,7 @@ class strided_iterator {
   constexpr strided_iterator(_Iterator start, const difference_type &stride)
       : _current(start), _stride(stride) {}
 
-  constexpr explicit strided_iterator(const strided_iterator &other)
+  constexpr strided_iterator(const strided_iterator &other)
       : _current(other._current), _stride(other._stride) {}
 
   strided_iterator &operator=(const strided_iterator &) = default;
@@ -49,14 +49,14 @@ class strided_iterator {
                              std::is_convertible<_Iter, _Iterator>::value,
                              bool>::type = true>
   constexpr strided_iterator(const strided_iterator<_Iter> &other)
-      : _current(other._current), _stride(other._stride) {}
+      : _current(other.base()), _stride(other.stride()) {}
 
   template <class _Iter, typename std::enable_if<
                              std::is_convertible<_Iter, _Iterator>::value,
                              bool>::type = true>
   constexpr strided_iterator &operator=(const strided_iterator<_Iter> &other) {
-    _current = other._current;
-    _stride = other._stride;
+    _current = other.base();
+    _stride = other.stride();
     return *this;
   }
 
@@ -87,7 +87,7 @@ class strided_iterator {
    *
    * @return *this
    */
-  constexpr reference &operator++() {
+  constexpr strided_iterator &operator++() {
     std::advance(_current, _stride);
     return *this;
   }
@@ -110,7 +110,7 @@ class strided_iterator {
    *
    * @return *this.
    */
-  constexpr reference operator--() {
+  constexpr strided_iterator &operator--() {
     static_assert(std::is_base_of<std::bidirectional_iterator_tag,
                                   iterator_category>::value,
                   "The iterator decorated must be BIDIRECTIONAL in order to "
@@ -146,7 +146,7 @@ class strided_iterator {
                                   iterator_category>::value,
                   "The iterator decorated must be RANDOM ACCESS in order to "
                   "use (foo + N) operator.");
-    return strided_iterator(_current + (n * _stride));
+    return strided_iterator(_current + (n * _stride), _stride);
   }
 
   /**
@@ -175,7 +175,7 @@ class strided_iterator {
                                   iterator_category>::value,
                   "The iterator decorated must be RANDOM ACCESS in order to "
                   "use (foo - N) operator.");
-    return strided_iterator(_current - (n * _stride));
+    return strided_iterator(_current - (n * _stride), _stride);
   }
 
   /**
@@ -235,10 +235,12 @@ template <class _IterL, class _IterR>
 inline constexpr bool operator<(const strided_iterator<_IterL> &lhs,
                                 const strided_iterator<_IterR> &rhs) {
   static_assert(
-      std::is_base_of<std::random_access_iterator_tag,
-                      typename decltype(lhs)::iterator_category>::value and
-          std::is_base_of<std::random_access_iterator_tag,
-                          typename decltype(rhs)::iterator_category>::value,
+      std::is_base_of<
+          std::random_access_iterator_tag,
+          typename strided_iterator<_IterL>::iterator_category>::value and
+          std::is_base_of<
+              std::random_access_iterator_tag,
+              typename strided_iterator<_IterR>::iterator_category>::value,
       "Both strided_iterator must be RANDOM ACCESS in order to "
       "use <, >, <= and >= comparisons.");
   return lhs.base() < rhs.base();
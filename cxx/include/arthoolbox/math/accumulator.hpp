@@ -0,0 +1,276 @@
+#pragma once
+/**
+ *   \file accumulator.hpp
+ *   \brief Contains a statistics accumulator, composed at compile time from
+ *   the statistics actually needed
+ */
+
+#include <algorithm>   // min, max
+#include <cassert>     // assert
+#include <cstdlib>     // std::size_t
+#include <limits>      // numeric_limits
+#include <type_traits> // is_same
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/** \brief Statistics that can be selected inside an Accumulator */
+namespace features {
+struct Count {};    /*!< Number of measurements */
+struct Sum {};      /*!< Sum of the measurements */
+struct Min {};      /*!< Smallest measurement */
+struct Max {};      /*!< Biggest measurement */
+struct Mean {};     /*!< Mean (implies Count) */
+struct Variance {}; /*!< Variance and sampled variance (implies Mean) */
+} // namespace features
+
+namespace details {
+
+template <class Feature, class... Features>
+constexpr bool contains = (std::is_same<Feature, Features>::value || ...);
+
+template <class Feature>
+constexpr bool is_feature =
+    contains<Feature, features::Count, features::Sum, features::Min,
+             features::Max, features::Mean, features::Variance>;
+
+/// Statistics computed, explicitly selected or required by an other one
+template <class... Features> struct Selection {
+  static_assert((is_feature<Features> && ...),
+                "Unknown feature, see arthoolbox::stats::features");
+
+  static constexpr bool variance = contains<features::Variance, Features...>;
+  static constexpr bool mean =
+      contains<features::Mean, Features...> || variance;
+  static constexpr bool count = contains<features::Count, Features...> || mean;
+  static constexpr bool sum = contains<features::Sum, Features...>;
+  static constexpr bool min = contains<features::Min, Features...>;
+  static constexpr bool max = contains<features::Max, Features...>;
+};
+
+/// Storage of one statistic, empty (no size thanks to EBO) when not enabled
+template <class Tag, class T, bool Enabled> struct Field {
+  T value;
+};
+
+template <class Tag, class T> struct Field<Tag, T, false> {};
+
+} // namespace details
+
+/**
+ *  \brief Enables online computation of the selected statistics, in a single
+ *  pass over the measurements
+ *
+ *  Only the selected Features (and the ones they depend on) are stored and
+ *  updated, everything is resolved at compile time: an
+ *  Accumulator<double, features::Min> costs exactly one std::min per update.
+ *  Mean and Variance are computed with update_recurring_mean and
+ *  update_recurring_sum_square.
+ *
+ *  Example:
+ *  \code
+ *  Accumulator<double, features::Min, features::Max, features::Variance> acc;
+ *  for (auto sample : samples) acc.updateWith(sample);
+ *  acc.getMin(); acc.getMax(); acc.getMean(); acc.getVariance();
+ *  \endcode
+ *
+ *  \notes This class is not thread safe, use one accumulator per thread and
+ *  merge() them.
+ *
+ *  \tparam T The measurement sample type (also used for all the statistics)
+ *  \tparam Features The statistics to compute (see stats::features)
+ */
+template <class T, class... Features>
+class Accumulator
+    : private details::Field<features::Count, std::size_t,
+                             details::Selection<Features...>::count>,
+      private details::Field<features::Sum, T,
+                             details::Selection<Features...>::sum>,
+      private details::Field<features::Min, T,
+                             details::Selection<Features...>::min>,
+      private details::Field<features::Max, T,
+                             details::Selection<Features...>::max>,
+      private details::Field<features::Mean, T,
+                             details::Selection<Features...>::mean>,
+      private details::Field<features::Variance, T,
+                             details::Selection<Features...>::variance> {
+  using selection = details::Selection<Features...>;
+
+public:
+  /// True when the statistic is computed (explicitly or as a dependency)
+  static constexpr bool with_count = selection::count;
+  static constexpr bool with_sum = selection::sum;
+  static constexpr bool with_min = selection::min;
+  static constexpr bool with_max = selection::max;
+  static constexpr bool with_mean = selection::mean;
+  static constexpr bool with_variance = selection::variance;
+
+  //! Default constructor
+  Accumulator() { reset(); }
+
+  /**
+   *  \brief Reset the statistics
+   */
+  void reset() noexcept {
+    if constexpr (with_count)
+      count() = 0;
+    if constexpr (with_sum)
+      sum() = T{};
+    if constexpr (with_min)
+      min() = std::numeric_limits<T>::max();
+    if constexpr (with_max)
+      max() = std::numeric_limits<T>::lowest();
+    if constexpr (with_mean)
+      mean() = T{};
+    if constexpr (with_variance)
+      sumSquare() = T{};
+  }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    static_assert(with_count, "Requires features::Count");
+    return count();
+  }
+
+  /**
+   *  \brief Get the sum of the measurements
+   *  \return T The sum
+   */
+  T getSum() const noexcept {
+    static_assert(with_sum, "Requires features::Sum");
+    return sum();
+  }
+
+  /**
+   *  \brief Get the smallest measurement
+   *  \return T The min (numeric_limits::max() without measurements)
+   */
+  T getMin() const noexcept {
+    static_assert(with_min, "Requires features::Min");
+    return min();
+  }
+
+  /**
+   *  \brief Get the biggest measurement
+   *  \return T The max (numeric_limits::lowest() without measurements)
+   */
+  T getMax() const noexcept {
+    static_assert(with_max, "Requires features::Max");
+    return max();
+  }
+
+  /**
+   *  \brief Get the currently computed mean
+   *  \return T The mean computed
+   */
+  T getMean() const noexcept {
+    static_assert(with_mean, "Requires features::Mean");
+    return mean();
+  }
+
+  /**
+   *  \brief Get the currently computed variance
+   *  \notes Number of measurement must be != 0
+   *  \return T the variance computed
+   */
+  T getVariance() const {
+    static_assert(with_variance, "Requires features::Variance");
+    assert(count() != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return sumSquare() / count();
+  }
+
+  /**
+   *  \brief Get the currently computed sampled variance
+   *  \notes Number of measurement must be > 1
+   *  \return T the sampled variance computed
+   */
+  T getSampledVariance() const {
+    static_assert(with_variance, "Requires features::Variance");
+    assert(count() > 1 &&
+           "Need at least 2 measurement to compute the sample variance");
+    return sumSquare() / (count() - 1);
+  }
+
+  /**
+   *  \brief Update the selected statistics with the new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  void updateWith(const T &new_data) noexcept {
+    if constexpr (with_count)
+      count()++;
+    if constexpr (with_sum)
+      sum() += new_data;
+    if constexpr (with_min)
+      min() = std::min(min(), new_data);
+    if constexpr (with_max)
+      max() = std::max(max(), new_data);
+    if constexpr (with_mean) {
+      const auto new_mean = update_recurring_mean(new_data, mean(), count());
+      if constexpr (with_variance)
+        sumSquare() = update_recurring_sum_square(new_data, sumSquare(),
+                                                  new_mean, mean());
+      mean() = new_mean;
+    }
+  }
+
+  /**
+   *  \brief Merge the statistics computed over an other set of measurements
+   *  \param[in] other The statistics to merge into *this
+   *  \return Accumulator& *this
+   */
+  Accumulator &merge(const Accumulator &other) noexcept {
+    if constexpr (with_sum)
+      sum() += other.sum();
+    if constexpr (with_min)
+      min() = std::min(min(), other.min());
+    if constexpr (with_max)
+      max() = std::max(max(), other.max());
+    if constexpr (with_mean) {
+      if (other.count() != 0) {
+        if constexpr (with_variance)
+          sumSquare() =
+              merge_recurring_sum_square(sumSquare(), mean(), count(),
+                                         other.sumSquare(), other.mean(),
+                                         other.count());
+        mean() = count() == 0 ? other.mean()
+                              : merge_recurring_mean(mean(), count(),
+                                                     other.mean(),
+                                                     other.count());
+      }
+    }
+    if constexpr (with_count)
+      count() += other.count();
+    return *this;
+  }
+
+private:
+  template <class Tag, class U> using field = details::Field<Tag, U, true>;
+
+  std::size_t &count() noexcept {
+    return field<features::Count, std::size_t>::value;
+  }
+  const std::size_t &count() const noexcept {
+    return field<features::Count, std::size_t>::value;
+  }
+  T &sum() noexcept { return field<features::Sum, T>::value; }
+  const T &sum() const noexcept { return field<features::Sum, T>::value; }
+  T &min() noexcept { return field<features::Min, T>::value; }
+  const T &min() const noexcept { return field<features::Min, T>::value; }
+  T &max() noexcept { return field<features::Max, T>::value; }
+  const T &max() const noexcept { return field<features::Max, T>::value; }
+  T &mean() noexcept { return field<features::Mean, T>::value; }
+  const T &mean() const noexcept { return field<features::Mean, T>::value; }
+  T &sumSquare() noexcept { return field<features::Variance, T>::value; }
+  const T &sumSquare() const noexcept {
+    return field<features::Variance, T>::value;
+  }
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,182 @@
+#pragma once
+/**
+ *   \file anomaly.hpp
+ *   \brief Contains tools to detect anomalous samples of a stream
+ */
+
+#include <cassert>     // assert
+#include <cstdlib>     // std::size_t
+#include <type_traits> // decay_t, is_same, void_t
+#include <utility>     // move, declval
+
+namespace arthoolbox {
+namespace stats {
+
+namespace details {
+
+/// Default callback of ZScoreDetector: no call at all
+struct NoAnomalyCallback {};
+
+/// Statistics providing getSumSquare()
+template <class Stats, class = void>
+struct has_sum_square : std::false_type {};
+template <class Stats>
+struct has_sum_square<
+    Stats, std::void_t<decltype(std::declval<const Stats &>().getSumSquare())>>
+    : std::true_type {};
+
+/// Statistics over a window, providing getWindowSize()
+template <class Stats, class = void>
+struct has_window_size : std::false_type {};
+template <class Stats>
+struct has_window_size<Stats, std::void_t<decltype(Stats::getWindowSize())>>
+    : std::true_type {};
+
+/// Tells if the statistics can hold the 2 samples needed by a detection
+template <class Stats> constexpr bool can_hold_warm_up() noexcept {
+  if constexpr (has_window_size<Stats>::value)
+    return Stats::getWindowSize() >= 2;
+  else
+    return true;
+}
+
+} // namespace details
+
+/**
+ *  \brief Flag the samples whose z-score, against the statistics of the
+ *  previous samples, exceeds a threshold
+ *
+ *  A sample X is scored before being added to the statistics (mean M,
+ *  variance V). Entering the anomalous state requires:
+ *  (X - M)^2 > threshold^2 * V
+ *  While anomalous, the state is kept until:
+ *  (X - M)^2 <= exit_threshold^2 * V
+ *  (hysteresis, exit_threshold <= threshold), avoiding to flap around the
+ *  threshold.
+ *
+ *  When the statistics provide their sum of squares SUM (RecurrentStatistics,
+ *  WindowedStatistics), V = SUM / N is not computed and the comparison is:
+ *  (X - M)^2 * N > threshold^2 * SUM
+ *
+ *  Comparing squared values avoids any sqrt/division: once warmed up, a
+ *  sample costs a few flops on top of the statistics update, and the only
+ *  branch is the (well predicted) warm up check: the threshold is indexed by
+ *  the current state. The callback, if any, is only called when the state
+ *  changes.
+ *
+ *  \notes Anomalous samples are added to the statistics too
+ *  \notes This class is not thread safe !
+ *
+ *  \tparam Stats The statistics used, providing updateWith(x), getMean(),
+ *          getVariance() and getNumberOfMeasurements() (RecurrentStatistics,
+ *          WindowedStatistics, ExponentialStatistics, ...)
+ *  \tparam Callback Callable as f(bool anomalous, const T& sample), called
+ *          when entering/leaving the anomalous state
+ */
+template <class Stats, class Callback = details::NoAnomalyCallback>
+class ZScoreDetector {
+  static_assert(details::can_hold_warm_up<Stats>(),
+                "The window must hold at least 2 samples (the minimal warm "
+                "up), otherwise nothing would ever be detected");
+
+public:
+  using statistics_type = Stats;
+  using value_type =
+      std::decay_t<decltype(std::declval<const Stats &>().getMean())>;
+
+  /**
+   *  \brief Construct the detector
+   *
+   *  \param[in] stats The initial statistics
+   *  \param[in] threshold The z-score above which a sample is anomalous (k)
+   *  \param[in] exit_threshold The z-score below which the anomalous state is
+   *             left (<= threshold, = threshold for no hysteresis)
+   *  \param[in] warm_up The number of samples recorded before any detection
+   *             (at least 2, at most the window size for windowed statistics
+   *             whose number of measurements never exceeds it)
+   *  \param[in] callback Called on each state change
+   */
+  ZScoreDetector(Stats stats, const value_type &threshold,
+                 const value_type &exit_threshold, const std::size_t warm_up,
+                 Callback callback = Callback())
+      : stats_(std::move(stats)), callback_(std::move(callback)),
+        thresholds_{threshold * threshold, exit_threshold * exit_threshold},
+        warm_up_(clampWarmUp(warm_up)), anomalous_(false),
+        number_of_anomalies_(0) {
+    assert(exit_threshold <= threshold &&
+           "The exit threshold must be <= to the threshold");
+  }
+
+  /**
+   *  \brief Get the underlying statistics
+   *  \return Stats const& The statistics
+   */
+  const Stats &getStatistics() const noexcept { return stats_; }
+
+  /**
+   *  \brief Tells if the detector is in the anomalous state
+   *  \return bool True if the last sample was flagged
+   */
+  bool isAnomalous() const noexcept { return anomalous_; }
+
+  /**
+   *  \brief Get the number of samples flagged as anomalous
+   *  \return std::size_t The number of anomalous samples
+   */
+  std::size_t getNumberOfAnomalies() const noexcept {
+    return number_of_anomalies_;
+  }
+
+  /**
+   *  \brief Score a new sample, then add it to the statistics
+   *  \param[in] new_data The new measurement
+   *  \return bool True if the sample is flagged as anomalous
+   */
+  template <class T> bool updateWith(const T &new_data) {
+    bool anomalous = false;
+    if (stats_.getNumberOfMeasurements() >= warm_up_) {
+      const value_type deviation = new_data - stats_.getMean();
+      if constexpr (details::has_sum_square<Stats>::value) {
+        const value_type n = stats_.getNumberOfMeasurements();
+        const value_type sum_square = stats_.getSumSquare();
+        anomalous = (deviation * deviation * n) >
+                    (thresholds_[anomalous_] * sum_square);
+      } else {
+        const value_type variance = stats_.getVariance();
+        anomalous =
+            (deviation * deviation) > (thresholds_[anomalous_] * variance);
+      }
+    }
+
+    if constexpr (not std::is_same<Callback,
+                                   details::NoAnomalyCallback>::value) {
+      if (anomalous != anomalous_)
+        callback_(anomalous, new_data);
+    }
+
+    anomalous_ = anomalous;
+    number_of_anomalies_ += anomalous;
+    stats_.updateWith(new_data);
+    return anomalous;
+  }
+
+private:
+  static constexpr std::size_t clampWarmUp(std::size_t warm_up) noexcept {
+    if constexpr (details::has_window_size<Stats>::value) {
+      // Otherwise the detection would never start
+      if (warm_up > Stats::getWindowSize())
+        warm_up = Stats::getWindowSize();
+    }
+    return warm_up < 2 ? 2 : warm_up;
+  }
+
+  Stats stats_;                     /*!< Hold the statistics */
+  Callback callback_;               /*!< Hold the state change callback */
+  value_type thresholds_[2];        /*!< Hold the squared enter/exit k */
+  std::size_t warm_up_;             /*!< Hold the warm up N */
+  bool anomalous_;                  /*!< Hold the current state */
+  std::size_t number_of_anomalies_; /*!< Hold the number of anomalies */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,173 @@
+#pragma once
+/**
+ *   \file channel_statistics.hpp
+ *   \brief Contains tools to perform per channel statistics over multi channel
+ *   frames
+ */
+
+#include <array>       // array
+#include <cassert>     // assert
+#include <cstdlib>     // std::size_t
+#include <type_traits> // enable_if, is_convertible
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Enables online recurrent statistics computation of each channel of
+ *  multi channel frames
+ *
+ *  This is equivalent to Channels RecurrentStatistics<T, T> (one per channel),
+ *  but the means and sums of squares of all the channels are stored in
+ *  contiguous arrays and all the channels share the same N. Updating with a
+ *  frame is then a loop over contiguous channels that the compiler can
+ *  vectorize.
+ *
+ *  \notes This class is not thread safe, use one accumulator per thread and
+ *  merge() them.
+ *
+ *  \tparam T The measurement sample type (and statistics type)
+ *  \tparam Channels The number of channels of a frame
+ */
+template <class T, std::size_t Channels> class ChannelStatistics {
+  static_assert(Channels > 0, "The number of channels must be > 0");
+
+public:
+  using channels_type = std::array<T, Channels>;
+
+  //! Default constructor
+  ChannelStatistics() : number_of_frames_(0), mean_(), sum_square_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  void reset() noexcept {
+    number_of_frames_ = 0;
+    mean_.fill(T{});
+    sum_square_.fill(T{});
+  };
+
+  /**
+   *  \brief Get the number of frames N (i.e. of measurements per channel)
+   *  \return std::size_t N the number of frames
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_frames_;
+  }
+
+  /**
+   *  \brief Get the currently computed means of all the channels
+   *  \return channels_type const& The means computed
+   */
+  const channels_type &getMeans() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the currently computed mean of one channel
+   *  \param[in] channel The channel index
+   *  \return T The mean computed
+   */
+  T getMean(const std::size_t channel) const noexcept {
+    return mean_[channel];
+  }
+
+  /**
+   *  \brief Get the currently computed variance of one channel
+   *  \notes Number of measurement must be != 0
+   *  \param[in] channel The channel index
+   *  \return T the variance computed
+   */
+  T getVariance(const std::size_t channel) const {
+    assert(number_of_frames_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return sum_square_[channel] / number_of_frames_;
+  }
+
+  /**
+   *  \brief Get the currently computed sampled variance of one channel
+   *  \notes Number of measurement must be > 1
+   *  \param[in] channel The channel index
+   *  \return T the sampled variance computed
+   */
+  T getSampledVariance(const std::size_t channel) const {
+    assert(number_of_frames_ > 1 &&
+           "Need at least 2 measurement to compute the sample variance");
+    return sum_square_[channel] / (number_of_frames_ - 1);
+  }
+
+  /**
+   *  \brief Update the computed stats with a new frame
+   *  \param[in] frame Pointer to the Channels contiguous values of the frame
+   */
+  void updateWith(const T *frame) noexcept {
+    number_of_frames_++;
+    for (std::size_t c = 0; c < Channels; ++c) {
+      const T delta = frame[c] - mean_[c];
+      mean_[c] += delta / number_of_frames_;
+      sum_square_[c] += delta * (frame[c] - mean_[c]);
+    }
+  }
+
+  /**
+   *  \brief Update the computed stats with a new frame, whose channels are not
+   *         contiguous (e.g. a iterator::strided_iterator over planar data)
+   *  \param[in] first Iterator to the first channel of the frame, Channels
+   *                   values are read from it
+   */
+  template <class InputIt,
+            typename std::enable_if<
+                not std::is_convertible<InputIt, const T *>::value,
+                bool>::type = true>
+  void updateWith(InputIt first) {
+    channels_type frame;
+    for (std::size_t c = 0; c < Channels; ++c, ++first)
+      frame[c] = *first;
+    updateWith(frame.data());
+  }
+
+  /**
+   *  \brief Update the computed stats with multiple interleaved frames
+   *  \param[in] frames Pointer to frame_count * Channels contiguous values
+   *  \param[in] frame_count The number of frames
+   */
+  void updateWith(const T *frames, const std::size_t frame_count) noexcept {
+    for (std::size_t f = 0; f < frame_count; ++f)
+      updateWith(frames + f * Channels);
+  }
+
+  /**
+   *  \brief Merge the stats computed over an other set of frames
+   *  \param[in] other The statistics to merge into *this
+   *  \return ChannelStatistics& *this
+   */
+  ChannelStatistics &merge(const ChannelStatistics &other) noexcept {
+    if (other.number_of_frames_ == 0)
+      return *this;
+
+    if (number_of_frames_ == 0) {
+      *this = other;
+      return *this;
+    }
+
+    const auto n_a = number_of_frames_;
+    const auto n_b = other.number_of_frames_;
+    for (std::size_t c = 0; c < Channels; ++c) {
+      sum_square_[c] = merge_recurring_sum_square(
+          sum_square_[c], mean_[c], n_a, other.sum_square_[c], other.mean_[c],
+          n_b);
+      mean_[c] = merge_recurring_mean(mean_[c], n_a, other.mean_[c], n_b);
+    }
+
+    number_of_frames_ = n_a + n_b;
+    return *this;
+  }
+
+private:
+  std::size_t number_of_frames_; /*!< Hold the current number of frames N */
+  channels_type mean_;           /*!< Hold the mean of each channel */
+  channels_type sum_square_;     /*!< Hold the sum square of each channel */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,193 @@
+#pragma once
+/**
+ *   \file covariance.hpp
+ *   \brief Contains tools to perform multivariate statistics computations
+ */
+
+#include <array>   // array
+#include <cassert> // assert
+#include <cstdlib> // std::size_t
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Enables online recurrent mean/covariance computation of a
+ *  multivariate sample
+ *
+ *  From the previous mean (M_n-1) and co-moment matrix (C_n-1), a new
+ *  measurement X_n updates them with:
+ *  M_n = M_n-1 + (X_n - M_n-1)/n
+ *  C_n = C_n-1 + (X_n - M_n-1) * (X_n - M_n)^T
+ *
+ *  The covariance is then C_n/n (or C_n/(n-1) for the sampled covariance).
+ *
+ *  The mean and co-moment matrix (row major, Dim x Dim) are stored as flat
+ *  arrays: each rank-1 update is a set of independent loops over Dim
+ *  contiguous values that the compiler can vectorize. No allocation is ever
+ *  performed.
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Covariance, Online)
+ *
+ *  \notes This class is not thread safe, use one accumulator per thread and
+ *  merge() them.
+ *
+ *  \tparam T The type of each sample component (and of the statistics)
+ *  \tparam Dim The number of components of a sample
+ */
+template <class T, std::size_t Dim> class RecurrentCovariance {
+  static_assert(Dim > 0, "The dimension must be > 0");
+
+public:
+  using vector_type = std::array<T, Dim>;
+  using matrix_type = std::array<T, Dim * Dim>;
+
+  //! Default constructor
+  RecurrentCovariance() : number_of_measurements_(0), mean_(), co_moment_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  void reset() noexcept {
+    number_of_measurements_ = 0;
+    mean_.fill(T{});
+    co_moment_.fill(T{});
+  };
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed mean vector
+   *  \return vector_type const& The mean computed
+   */
+  const vector_type &getMean() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the currently computed co-moment matrix C (row major)
+   *  \return matrix_type const& The co-moment computed
+   */
+  const matrix_type &getCoMoment() const noexcept { return co_moment_; }
+
+  /**
+   *  \brief Get one element of the currently computed covariance matrix
+   *  \notes Number of measurement must be != 0
+   *  \param[in] row, col The position inside the matrix
+   *  \return T the covariance between the components row and col
+   */
+  T getCovariance(const std::size_t row, const std::size_t col) const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the covariance");
+    return co_moment_[row * Dim + col] / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed covariance matrix (row major)
+   *  \notes Number of measurement must be != 0
+   *  \return matrix_type the covariance computed
+   */
+  matrix_type getCovariance() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the covariance");
+    return divided(number_of_measurements_);
+  }
+
+  /**
+   *  \brief Get the currently computed sampled covariance matrix (row major)
+   *  \notes Number of measurement must be > 1
+   *  \return matrix_type the sampled covariance computed
+   */
+  matrix_type getSampledCovariance() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the sample covariance");
+    return divided(number_of_measurements_ - 1);
+  }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] new_data Pointer to the Dim components of the new measurement
+   */
+  void updateWith(const T *new_data) noexcept {
+    number_of_measurements_++;
+
+    T delta_old[Dim];
+    T delta_new[Dim];
+    for (std::size_t i = 0; i < Dim; ++i) {
+      delta_old[i] = new_data[i] - mean_[i];
+      mean_[i] += delta_old[i] / number_of_measurements_;
+      delta_new[i] = new_data[i] - mean_[i];
+    }
+
+    for (std::size_t row = 0; row < Dim; ++row)
+      for (std::size_t col = 0; col < Dim; ++col)
+        co_moment_[row * Dim + col] += delta_old[row] * delta_new[col];
+  }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] new_data The new measurement
+   */
+  void updateWith(const vector_type &new_data) noexcept {
+    updateWith(new_data.data());
+  }
+
+  /**
+   *  \brief Merge the stats computed over an other set of measurements
+   *
+   *  Each mean and co-moment is merged using merge_recurring_mean and
+   *  merge_recurring_co_moment.
+   *
+   *  \param[in] other The statistics to merge into *this
+   *  \return RecurrentCovariance& *this
+   */
+  RecurrentCovariance &merge(const RecurrentCovariance &other) noexcept {
+    if (other.number_of_measurements_ == 0)
+      return *this;
+
+    if (number_of_measurements_ == 0) {
+      *this = other;
+      return *this;
+    }
+
+    const auto n_a = number_of_measurements_;
+    const auto n_b = other.number_of_measurements_;
+
+    // Co-moments first, they depend on the means before the merge
+    for (std::size_t row = 0; row < Dim; ++row)
+      for (std::size_t col = 0; col < Dim; ++col)
+        co_moment_[row * Dim + col] = merge_recurring_co_moment(
+            co_moment_[row * Dim + col], mean_[row], mean_[col], n_a,
+            other.co_moment_[row * Dim + col], other.mean_[row],
+            other.mean_[col], n_b);
+
+    for (std::size_t i = 0; i < Dim; ++i)
+      mean_[i] = merge_recurring_mean(mean_[i], n_a, other.mean_[i], n_b);
+
+    number_of_measurements_ = n_a + n_b;
+    return *this;
+  }
+
+private:
+  matrix_type divided(const std::size_t n) const noexcept {
+    matrix_type out;
+    for (std::size_t i = 0; i < Dim * Dim; ++i)
+      out[i] = co_moment_[i] / n;
+    return out;
+  }
+
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  vector_type mean_;           /*!< Hold the currently computed mean */
+  matrix_type co_moment_;      /*!< Hold the co-moment matrix (row major) */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,304 @@
+#pragma once
+/**
+ *   \file exponential_statistics.hpp
+ *   \brief Contains tools to perform exponentially weighted statistics
+ */
+
+#include <chrono>  // durations, time_point
+#include <cmath>   // exp2
+#include <cstdlib> // std::size_t
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Update the exponentially weighted mean
+ *
+ *  From the previously computed mean (M_n-1) and a new measurement (X_n), we
+ *  compute the new mean (M_n) using the smoothing factor alpha with:
+ *  M_n = M_n-1 + alpha * (X_n - M_n-1)
+ *
+ *  See: https://en.wikipedia.org/wiki/Moving_average
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \param[in] alpha The smoothing factor, in [0, 1]
+ *  \return U The new mean computed
+ */
+template <class T, class U = T>
+constexpr U update_exponential_mean(const T &new_sample, const U &old_mean,
+                                    const U &alpha) noexcept {
+  return (old_mean + alpha * (new_sample - old_mean));
+}
+
+/**
+ *  \brief Update the exponentially weighted variance
+ *
+ *  From the previously computed variance and mean (V_n-1, M_n-1) and a new
+ *  measurement (X_n), we compute the new variance (V_n) using the smoothing
+ *  factor alpha with:
+ *  V_n = (1 - alpha) * (V_n-1 + alpha * (X_n - M_n-1)^2)
+ *
+ *  See: Finch, T. "Incremental calculation of weighted mean and variance"
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean type
+ *  \tparam V The variance type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_variance The previously computed variance Vn-1
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \param[in] alpha The smoothing factor, in [0, 1]
+ *  \return V The new variance computed
+ */
+template <class T, class U = T, class V = U>
+constexpr V update_exponential_variance(const T &new_sample,
+                                        const V &old_variance,
+                                        const U &old_mean,
+                                        const U &alpha) noexcept {
+  return ((1 - alpha) * (old_variance + alpha * (new_sample - old_mean) *
+                                            (new_sample - old_mean)));
+}
+
+/**
+ *  \brief Compute the smoothing factor corresponding to a half-life
+ *
+ *  The weight of a measurement is halved every half_life. After an elapsed
+ *  time dt since the previous measurement, the smoothing factor is:
+ *  alpha = 1 - 2^(-dt / half_life)
+ *
+ *  \param[in] elapsed The time dt elapsed since the previous measurement
+ *  \param[in] half_life The half-life (must be > 0)
+ *  \return U The smoothing factor alpha, in [0, 1]
+ */
+template <class U, class Rep1, class Period1, class Rep2, class Period2>
+U half_life_to_alpha(const std::chrono::duration<Rep1, Period1> &elapsed,
+                     const std::chrono::duration<Rep2, Period2> &half_life) {
+  using seconds = std::chrono::duration<U>;
+  const auto ratio = std::chrono::duration_cast<seconds>(elapsed).count() /
+                     std::chrono::duration_cast<seconds>(half_life).count();
+  return ratio > 0 ? U(1) - std::exp2(-ratio) : U(0);
+}
+
+/**
+ *  \brief Enables online exponentially weighted statistics computation using a
+ *  fixed smoothing factor
+ *
+ *  The first measurement initializes the mean, each next measurement X_n
+ *  updates the mean and variance with update_exponential_mean and
+ *  update_exponential_variance.
+ *
+ *  \notes This class is not thread safe !
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam U The mean type
+ *  \tparam S The variance type
+ */
+template <class T, class U = T, class S = U> class ExponentialStatistics {
+public:
+  /**
+   *  \brief Constructor
+   *  \param[in] alpha The smoothing factor, in ]0, 1]
+   */
+  constexpr explicit ExponentialStatistics(const U &alpha)
+      : alpha_(alpha), number_of_measurements_(0), mean_(), variance_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  constexpr void reset() noexcept {
+    number_of_measurements_ = 0;
+    mean_ = U{};
+    variance_ = S{};
+  };
+
+  /**
+   *  \brief Get the smoothing factor used
+   *  \return U alpha
+   */
+  constexpr U getAlpha() const noexcept { return alpha_; }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  constexpr std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed mean
+   *  \return U The mean computed
+   */
+  constexpr U getMean() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the currently computed variance
+   *  \return S the variance computed
+   */
+  constexpr S getVariance() const noexcept { return variance_; }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  constexpr void updateWith(const T &new_data) noexcept {
+    if (number_of_measurements_++ == 0) {
+      mean_ = new_data;
+      variance_ = S{};
+    } else {
+      variance_ = update_exponential_variance(new_data, variance_, mean_,
+                                              alpha_);
+      mean_ = update_exponential_mean(new_data, mean_, alpha_);
+    }
+  };
+
+private:
+  U alpha_;                    /*!< Hold the smoothing factor */
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  U mean_;                     /*!< Hold the currently computed mean */
+  S variance_;                 /*!< Hold the currently computed variance */
+};
+
+/**
+ *  \brief Enables online time decayed statistics computation of measurements
+ *  received at irregular times
+ *
+ *  The weight of a measurement is halved every half-life: the smoothing factor
+ *  of each update is computed from the time elapsed since the previous
+ *  measurement (see half_life_to_alpha).
+ *
+ *  Measurements sharing the same timestamp (coarse clocks, bursts) are folded
+ *  together: they share equally the weight (alpha) of that timestamp.
+ *
+ *  \notes Measurements older than the latest one are ignored (not counted)
+ *  \notes This class is not thread safe !
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam Clock The clock providing the measurements timestamps
+ *  \tparam U The mean type
+ *  \tparam S The variance type
+ */
+template <class T, class Clock = std::chrono::steady_clock, class U = T,
+          class S = U>
+class TimeDecayedStatistics {
+public:
+  using duration = typename Clock::duration;
+  using time_point = typename Clock::time_point;
+
+  /**
+   *  \brief Constructor
+   *  \param[in] half_life The duration after which a measurement weight is
+   *                       halved (must be > 0)
+   */
+  constexpr explicit TimeDecayedStatistics(const duration &half_life)
+      : half_life_(half_life), last_timestamp_(), number_of_measurements_(0),
+        mean_(), variance_(), group_alpha_(), group_size_(0), group_mean_(),
+        group_sum_square_(), base_mean_(), base_variance_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  constexpr void reset() noexcept {
+    number_of_measurements_ = 0;
+    mean_ = U{};
+    variance_ = S{};
+  };
+
+  /**
+   *  \brief Get the half-life used
+   *  \return duration The half-life
+   */
+  constexpr duration getHalfLife() const noexcept { return half_life_; }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  constexpr std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the timestamp of the latest measurement
+   *  \return time_point The latest timestamp
+   */
+  constexpr time_point getLastTimestamp() const noexcept {
+    return last_timestamp_;
+  }
+
+  /**
+   *  \brief Get the currently computed mean
+   *  \return U The mean computed
+   */
+  constexpr U getMean() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the currently computed variance
+   *  \return S the variance computed
+   */
+  constexpr S getVariance() const noexcept { return variance_; }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   *  \param[in] timestamp The time at which new_data has been measured
+   *  \return bool False when the measurement is ignored (older than the
+   *          latest one)
+   */
+  bool updateWith(const T &new_data, const time_point &timestamp) {
+    if ((number_of_measurements_ != 0) and (timestamp < last_timestamp_))
+      return false;
+
+    if ((number_of_measurements_ == 0) or (timestamp > last_timestamp_)) {
+      // New timestamp: the current stats become the base of a new group
+      group_alpha_ = number_of_measurements_ == 0
+                         ? U{1}
+                         : half_life_to_alpha<U>(timestamp - last_timestamp_,
+                                                 half_life_);
+      group_size_ = 0;
+      group_mean_ = U{};
+      group_sum_square_ = S{};
+      base_mean_ = mean_;
+      base_variance_ = variance_;
+      last_timestamp_ = timestamp;
+    }
+
+    ++number_of_measurements_;
+    ++group_size_;
+    const auto old_group_mean = group_mean_;
+    group_mean_ = update_recurring_mean(new_data, group_mean_, group_size_);
+    group_sum_square_ = update_recurring_sum_square(
+        new_data, group_sum_square_, group_mean_, old_group_mean);
+
+    // The group weights alpha, with its mean and its own spread
+    mean_ = update_exponential_mean(group_mean_, base_mean_, group_alpha_);
+    variance_ = update_exponential_variance(group_mean_, base_variance_,
+                                            base_mean_, group_alpha_) +
+                group_alpha_ * group_sum_square_ / group_size_;
+    return true;
+  };
+
+private:
+  duration half_life_;         /*!< Hold the half-life */
+  time_point last_timestamp_;  /*!< Hold the latest measurement timestamp */
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  U mean_;                     /*!< Hold the currently computed mean */
+  S variance_;                 /*!< Hold the currently computed variance */
+  U group_alpha_;              /*!< Hold the latest timestamp weight */
+  std::size_t group_size_;     /*!< Hold its number of measurements */
+  U group_mean_;               /*!< Hold its measurements mean */
+  S group_sum_square_;         /*!< Hold its measurements sum of squares */
+  U base_mean_;                /*!< Hold the mean before that timestamp */
+  S base_variance_;            /*!< Hold the variance before it */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,268 @@
+#pragma once
+/**
+ *   \file histogram.hpp
+ *   \brief Contains a log bucketed histogram, to record values (latencies)
+ *   spanning multiple orders of magnitude
+ */
+
+#include <algorithm> // min, max
+#include <cassert>   // assert
+#include <cmath>     // ceil
+#include <cstdint>   // uint64_t
+#include <cstdlib>   // std::size_t
+#include <limits>    // numeric_limits
+#include <sstream>   // stringstream
+#include <stdexcept> // invalid_argument
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+
+namespace snapshot {
+struct Access;
+} // namespace snapshot
+
+/**
+ *  \brief Histogram of unsigned integer values with log distributed buckets
+ *
+ *  Values below 2^P (P being the precision, in bits) each have their own
+ *  bucket. Above, buckets are grouped by power of 2 and each power of 2 is
+ *  split in 2^(P-1) linear sub buckets. The width of a bucket is therefore
+ *  always lower than 2^(1-P) times its lower bound (i.e. ~0.8% of relative
+ *  error with P = 7).
+ *
+ *  For a value V, with MSB its most significant bit, the bucket index is:
+ *  SHIFT = max(0, MSB + 1 - P)
+ *  INDEX = SHIFT * 2^(P-1) + (V >> SHIFT)
+ *
+ *  Recording a value only costs a bit scan, a few shifts/adds and an increment
+ *  (no floating point operation and no allocation).
+ *
+ *  \notes This class is not thread safe, use one histogram per thread and
+ *  merge() them.
+ */
+class LogHistogram {
+public:
+  using value_type = std::uint64_t;
+  using count_type = std::uint64_t;
+
+  /**
+   *  \brief Constructor
+   *  \param[in] max_value The highest value that can be recorded precisely
+   *                       (higher values are recorded in the last bucket)
+   *  \param[in] precision The number of significant bits P kept, in [1, 32]
+   *  \throw std::invalid_argument If the precision isn't in [1, 32]
+   */
+  explicit LogHistogram(const value_type max_value = value_type(1) << 40,
+                        const unsigned precision = 7)
+      : precision_(checkPrecision(precision)),
+        max_value_(max_value),
+        counts_(indexOf(max_value, precision_) + 1, 0),
+        number_of_measurements_(0),
+        min_(std::numeric_limits<value_type>::max()),
+        max_(0) {}
+
+  /**
+   *  \brief Reset the histogram (N set to 0)
+   */
+  void reset() noexcept {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    number_of_measurements_ = 0;
+    min_ = std::numeric_limits<value_type>::max();
+    max_ = 0;
+  }
+
+  /**
+   *  \brief Get the precision P used
+   *  \return unsigned The number of significant bits kept
+   */
+  unsigned getPrecision() const noexcept { return precision_; }
+
+  /**
+   *  \brief Get the highest value that can be recorded precisely
+   *  \return value_type The max value
+   */
+  value_type getMaxValue() const noexcept { return max_value_; }
+
+  /**
+   *  \brief Get the number of buckets used
+   *  \return std::size_t The number of buckets
+   */
+  std::size_t getNumberOfBuckets() const noexcept { return counts_.size(); }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return count_type N the number of measurment
+   */
+  count_type getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the smallest value recorded
+   *  \return value_type The min (numeric_limits::max() when N = 0)
+   */
+  value_type getMin() const noexcept { return min_; }
+
+  /**
+   *  \brief Get the biggest value recorded
+   *  \return value_type The max (0 when N = 0)
+   */
+  value_type getMax() const noexcept { return max_; }
+
+  /**
+   *  \brief Record a new value
+   *  \param[in] value The new value
+   *  \param[in] count The number of times value should be recorded
+   */
+  void record(const value_type value, const count_type count = 1) noexcept {
+    const auto index = std::min(indexOf(value, precision_), counts_.size() - 1);
+    counts_[index] += count;
+    number_of_measurements_ += count;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  /**
+   *  \brief Merge an other histogram into this one
+   *  \notes Both histograms must have the same max value and precision
+   *  \param[in] other The histogram to merge into *this
+   *  \return LogHistogram& *this
+   */
+  LogHistogram &merge(const LogHistogram &other) noexcept {
+    assert(other.precision_ == precision_ &&
+           other.max_value_ == max_value_ &&
+           "Can't merge histograms with different configurations");
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+      counts_[i] += other.counts_[i];
+    number_of_measurements_ += other.number_of_measurements_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    return *this;
+  }
+
+  /**
+   *  \brief Get the value at the given quantile
+   *  \notes Number of measurement must be != 0
+   *  \param[in] q The quantile requested, in [0, 1] (0.5 for the median)
+   *  \return value_type The highest value that is equivalent (same bucket) to
+   *          the value below which a fraction q of the measurements are
+   */
+  value_type quantile(const double q) const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute a quantile");
+    if (q <= 0)
+      return min_;
+
+    const auto rank = std::max<count_type>(
+        1, static_cast<count_type>(std::ceil(q * number_of_measurements_)));
+
+    count_type cumulated = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      cumulated += counts_[i];
+      if (cumulated >= rank) {
+        // The last bucket also holds the values above max_value
+        const bool last_bucket = (i + 1 == counts_.size());
+        return last_bucket ? max_ : std::min(upperBoundOf(i) - 1, max_);
+      }
+    }
+    return max_;
+  }
+
+  /**
+   *  \brief Call f(lower, upper, count) on each non empty bucket, by
+   *         increasing values
+   *
+   *  A bucket contains count values in [lower, upper[.
+   *
+   *  \param[in] f The functor to call
+   */
+  template <class F> void forEachBucket(F &&f) const {
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+      if (counts_[i] != 0)
+        f(lowerBoundOf(i), upperBoundOf(i), counts_[i]);
+  }
+
+  /**
+   *  \brief Get the index of the bucket in which a value is recorded
+   *  \param[in] value The value
+   *  \param[in] precision The number of significant bits P kept
+   *  \return std::size_t The bucket index (not clamped to the max value)
+   */
+  static constexpr std::size_t indexOf(const value_type value,
+                                       const unsigned precision) noexcept {
+    const unsigned bits = 64 - __builtin_clzll(value | 1);
+    const unsigned shift = bits > precision ? bits - precision : 0;
+    return (std::size_t(shift) << (precision - 1)) + (value >> shift);
+  }
+
+  /**
+   *  \brief Get the smallest value recorded in the bucket index
+   *  \param[in] index The bucket index
+   *  \return value_type The lower bound (included) of the bucket
+   */
+  value_type lowerBoundOf(const std::size_t index) const noexcept {
+    if (index < (std::size_t(1) << precision_))
+      return index;
+
+    const auto shift = (index >> (precision_ - 1)) - 1;
+    return value_type(index - (shift << (precision_ - 1))) << shift;
+  }
+
+  /**
+   *  \brief Get the smallest value above the bucket index
+   *  \param[in] index The bucket index
+   *  \return value_type The upper bound (excluded) of the bucket
+   */
+  value_type upperBoundOf(const std::size_t index) const noexcept {
+    if (index < (std::size_t(1) << precision_))
+      return index + 1;
+
+    const auto shift = (index >> (precision_ - 1)) - 1;
+    return lowerBoundOf(index) + (value_type(1) << shift);
+  }
+
+private:
+  friend struct snapshot::Access; /*!< Binary (de)serialization */
+
+  /// Validate the precision before it is used to size the buckets
+  static unsigned checkPrecision(const unsigned precision) {
+    if (precision < 1 || precision > 32)
+      throw std::invalid_argument("LogHistogram precision must be in [1, 32]");
+    return precision;
+  }
+
+  unsigned precision_;             /*!< Hold the number of significant bits */
+  value_type max_value_;           /*!< Hold the highest value recordable */
+  std::vector<count_type> counts_; /*!< Hold the count of each bucket */
+  count_type number_of_measurements_; /*!< Hold the number of measurment N */
+  value_type min_;                    /*!< Hold the smallest value recorded */
+  value_type max_;                    /*!< Hold the biggest value recorded */
+};
+
+/**
+ *  \brief Format a LogHistogram to a string
+ *  \param[in] histogram The LogHistogram object to format
+ *  \return std::string The string format of the LogHistogram
+ */
+inline std::string format(const LogHistogram &histogram) {
+  std::stringstream output;
+  const auto n = histogram.getNumberOfMeasurements();
+  output << "Histogram [N = " << n << "]";
+
+  if (n == 0) {
+    output << " -> Not enough samples yet";
+  } else {
+    output << "\nMin : " << histogram.getMin();
+    output << "\np50 : " << histogram.quantile(0.5);
+    output << "\np90 : " << histogram.quantile(0.9);
+    output << "\np99 : " << histogram.quantile(0.99);
+    output << "\np999: " << histogram.quantile(0.999);
+    output << "\nMax : " << histogram.getMax();
+  }
+
+  return output.str();
+}
+
+} // namespace stats
+} // namespace arthoolbox
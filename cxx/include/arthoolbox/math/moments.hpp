@@ -0,0 +1,314 @@
+#pragma once
+/**
+ *   \file moments.hpp
+ *   \brief Contains tools to compute higher order moments (skewness, kurtosis)
+ *   in a single pass
+ */
+
+#include <cassert> // assert
+#include <cmath>   // sqrt
+#include <cstdlib> // std::size_t
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Update the third central moment sum using recurrent equation
+ *
+ *  With delta = X_n - M_n-1, the third central moment sum (M3_n) is computed
+ *  from the previous central moment sums (M2_n-1, M3_n-1) using:
+ *  M3_n = M3_n-1 + delta^3 * (n-1) * (n-2) / n^2 - 3 * delta * M2_n-1 / n
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Higher-order statistics)
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean/moments type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_m3 The previously computed third moment sum M3_n-1
+ *  \param[in] old_m2 The previously computed sum of squares M2_n-1
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \param[in] data_number The number of data n used to compute M3_n
+ *  \return U The new third central moment sum computed
+ */
+template <class T, class U = T>
+constexpr U
+update_recurring_third_moment(const T &new_sample, const U &old_m3,
+                              const U &old_m2, const U &old_mean,
+                              const std::size_t data_number) noexcept {
+  const U n = static_cast<U>(data_number);
+  const U delta = new_sample - old_mean;
+  const U delta_n = delta / n;
+  return (old_m3 + delta * delta_n * delta_n * (n - 1) * (n - 2) -
+          3 * delta_n * old_m2);
+}
+
+/**
+ *  \brief Update the fourth central moment sum using recurrent equation
+ *
+ *  With delta = X_n - M_n-1, the fourth central moment sum (M4_n) is computed
+ *  from the previous central moment sums (M2_n-1, M3_n-1, M4_n-1) using:
+ *  M4_n = M4_n-1 + delta^4 * (n-1) * (n^2 - 3n + 3) / n^3
+ *                + 6 * delta^2 * M2_n-1 / n^2 - 4 * delta * M3_n-1 / n
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Higher-order statistics)
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean/moments type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_m4 The previously computed fourth moment sum M4_n-1
+ *  \param[in] old_m3 The previously computed third moment sum M3_n-1
+ *  \param[in] old_m2 The previously computed sum of squares M2_n-1
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \param[in] data_number The number of data n used to compute M4_n
+ *  \return U The new fourth central moment sum computed
+ */
+template <class T, class U = T>
+constexpr U
+update_recurring_fourth_moment(const T &new_sample, const U &old_m4,
+                               const U &old_m3, const U &old_m2,
+                               const U &old_mean,
+                               const std::size_t data_number) noexcept {
+  const U n = static_cast<U>(data_number);
+  const U delta = new_sample - old_mean;
+  const U delta_n = delta / n;
+  const U delta_n2 = delta_n * delta_n;
+  return (old_m4 + delta * delta_n * delta_n2 * (n - 1) * (n * n - 3 * n + 3) +
+          6 * delta_n2 * old_m2 - 4 * delta_n * old_m3);
+}
+
+/**
+ *  \brief Merge two third central moment sums computed over disjoint sets of
+ *  data
+ *
+ *  With delta = M_b - M_a and n = n_a + n_b, the third central moment sum of
+ *  the union of both sets (M3_ab) is computed using:
+ *  M3_ab = M3_a + M3_b + delta^3 * n_a * n_b * (n_a - n_b) / n^2
+ *                      + 3 * delta * (n_a * M2_b - n_b * M2_a) / n
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Higher-order statistics)
+ *
+ *  \tparam U The mean/moments type
+ *
+ *  \param[in] lhs_m3, lhs_m2, lhs_mean The M3_a, M2_a and M_a of the first set
+ *  \param[in] lhs_data_number The number of data n_a of the first set
+ *  \param[in] rhs_m3, rhs_m2, rhs_mean The M3_b, M2_b and M_b of the second set
+ *  \param[in] rhs_data_number The number of data n_b of the second set
+ *  \return U The merged third central moment sum M3_ab (n must be != 0)
+ */
+template <class U>
+constexpr U merge_recurring_third_moment(
+    const U &lhs_m3, const U &lhs_m2, const U &lhs_mean,
+    const std::size_t lhs_data_number, const U &rhs_m3, const U &rhs_m2,
+    const U &rhs_mean, const std::size_t rhs_data_number) noexcept {
+  const U na = static_cast<U>(lhs_data_number);
+  const U nb = static_cast<U>(rhs_data_number);
+  const U delta = rhs_mean - lhs_mean;
+  const U delta_n = delta / (na + nb);
+  return (lhs_m3 + rhs_m3 + delta * delta_n * delta_n * na * nb * (na - nb) +
+          3 * delta_n * (na * rhs_m2 - nb * lhs_m2));
+}
+
+/**
+ *  \brief Merge two fourth central moment sums computed over disjoint sets of
+ *  data
+ *
+ *  With delta = M_b - M_a and n = n_a + n_b, the fourth central moment sum of
+ *  the union of both sets (M4_ab) is computed using:
+ *  M4_ab = M4_a + M4_b
+ *          + delta^4 * n_a * n_b * (n_a^2 - n_a * n_b + n_b^2) / n^3
+ *          + 6 * delta^2 * (n_a^2 * M2_b + n_b^2 * M2_a) / n^2
+ *          + 4 * delta * (n_a * M3_b - n_b * M3_a) / n
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Higher-order statistics)
+ *
+ *  \tparam U The mean/moments type
+ *
+ *  \param[in] lhs_m4, lhs_m3, lhs_m2, lhs_mean The M4_a, M3_a, M2_a and M_a of
+ *  the first set
+ *  \param[in] lhs_data_number The number of data n_a of the first set
+ *  \param[in] rhs_m4, rhs_m3, rhs_m2, rhs_mean The M4_b, M3_b, M2_b and M_b of
+ *  the second set
+ *  \param[in] rhs_data_number The number of data n_b of the second set
+ *  \return U The merged fourth central moment sum M4_ab (n must be != 0)
+ */
+template <class U>
+constexpr U merge_recurring_fourth_moment(
+    const U &lhs_m4, const U &lhs_m3, const U &lhs_m2, const U &lhs_mean,
+    const std::size_t lhs_data_number, const U &rhs_m4, const U &rhs_m3,
+    const U &rhs_m2, const U &rhs_mean,
+    const std::size_t rhs_data_number) noexcept {
+  const U na = static_cast<U>(lhs_data_number);
+  const U nb = static_cast<U>(rhs_data_number);
+  const U delta = rhs_mean - lhs_mean;
+  const U delta_n = delta / (na + nb);
+  const U delta_n2 = delta_n * delta_n;
+  return (lhs_m4 + rhs_m4 +
+          delta * delta_n * delta_n2 * na * nb * (na * na - na * nb + nb * nb) +
+          6 * delta_n2 * (na * na * rhs_m2 + nb * nb * lhs_m2) +
+          4 * delta_n * (na * rhs_m3 - nb * lhs_m3));
+}
+
+/**
+ *  \brief Enables online computation of the first four central moments (mean,
+ *  variance, skewness and kurtosis) in a single pass
+ *
+ *  \notes This class is not thread safe, use one accumulator per thread and
+ *  merge() them.
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam U The mean/moments type (floating point)
+ */
+template <class T, class U = T> class RecurrentMoments {
+public:
+  //! Default constructor
+  RecurrentMoments()
+      : number_of_measurements_(0), mean_(), m2_(), m3_(), m4_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  void reset() noexcept {
+    number_of_measurements_ = 0;
+    mean_ = m2_ = m3_ = m4_ = U{};
+  };
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed mean
+   *  \return U The mean computed
+   */
+  U getMean() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the currently computed variance
+   *  \notes Number of measurement must be != 0
+   *  \return U the variance computed
+   */
+  U getVariance() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return m2_ / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed sampled variance
+   *  \notes Number of measurement must be > 1
+   *  \return U the sampled variance computed
+   */
+  U getSampledVariance() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the sample variance");
+    return m2_ / (number_of_measurements_ - 1);
+  }
+
+  /**
+   *  \brief Get the currently computed skewness: sqrt(n) * M3 / M2^(3/2)
+   *  \notes Number of measurement must be != 0, with a non null variance
+   *  \return U the skewness computed
+   */
+  U getSkewness() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the skewness");
+    using std::sqrt;
+    return sqrt(static_cast<U>(number_of_measurements_)) * m3_ /
+           (m2_ * sqrt(m2_));
+  }
+
+  /**
+   *  \brief Get the currently computed kurtosis: n * M4 / M2^2
+   *  \notes Number of measurement must be != 0, with a non null variance
+   *  \return U the kurtosis computed (3 for a normal distribution)
+   */
+  U getKurtosis() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the kurtosis");
+    return static_cast<U>(number_of_measurements_) * m4_ / (m2_ * m2_);
+  }
+
+  /**
+   *  \brief Get the currently computed excess kurtosis (kurtosis - 3)
+   *  \notes Number of measurement must be != 0, with a non null variance
+   *  \return U the excess kurtosis computed (0 for a normal distribution)
+   */
+  U getExcessKurtosis() const { return getKurtosis() - 3; }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  void updateWith(const T &new_data) {
+    number_of_measurements_++;
+    const auto n = number_of_measurements_;
+
+    // Higher moments first, they depend on the previous lower ones
+    m4_ = update_recurring_fourth_moment(new_data, m4_, m3_, m2_, mean_, n);
+    m3_ = update_recurring_third_moment(new_data, m3_, m2_, mean_, n);
+
+    const U old_mean = mean_;
+    mean_ = update_recurring_mean(new_data, old_mean, n);
+    m2_ = update_recurring_sum_square(new_data, m2_, mean_, old_mean);
+  };
+
+  /**
+   *  \brief Merge the stats computed over an other set of measurements
+   *
+   *  The mean and sum of squares are merged using merge_recurring_mean and
+   *  merge_recurring_sum_square, the higher moments using
+   *  merge_recurring_third_moment and merge_recurring_fourth_moment.
+   *
+   *  See: Pébay, P. "Formulas for Robust, One-Pass Parallel Computation of
+   *  Covariances and Arbitrary-Order Statistical Moments"
+   *
+   *  \param[in] other The statistics to merge into *this
+   *  \return RecurrentMoments& *this
+   */
+  RecurrentMoments &merge(const RecurrentMoments &other) {
+    if (other.number_of_measurements_ == 0)
+      return *this;
+
+    if (number_of_measurements_ == 0) {
+      *this = other;
+      return *this;
+    }
+
+    const auto n_a = number_of_measurements_;
+    const auto n_b = other.number_of_measurements_;
+
+    // Higher moments first, they depend on the lower ones before the merge
+    m4_ = merge_recurring_fourth_moment(m4_, m3_, m2_, mean_, n_a, other.m4_,
+                                        other.m3_, other.m2_, other.mean_, n_b);
+    m3_ = merge_recurring_third_moment(m3_, m2_, mean_, n_a, other.m3_,
+                                       other.m2_, other.mean_, n_b);
+    m2_ = merge_recurring_sum_square(m2_, mean_, n_a, other.m2_, other.mean_,
+                                     n_b);
+    mean_ = merge_recurring_mean(mean_, n_a, other.mean_, n_b);
+    number_of_measurements_ = n_a + n_b;
+    return *this;
+  }
+
+private:
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  U mean_;                     /*!< Hold the currently computed mean */
+  U m2_;                       /*!< Hold the second central moment sum */
+  U m3_;                       /*!< Hold the third central moment sum */
+  U m4_;                       /*!< Hold the fourth central moment sum */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,294 @@
+#pragma once
+/**
+ *   \file quantile.hpp
+ *   \brief Contains tools to estimate quantiles of unbounded streams
+ */
+
+#include <algorithm>   // sort, merge, min, max
+#include <cassert>     // assert
+#include <cmath>       // asin, sin
+#include <cstdlib>     // std::size_t
+#include <iterator>    // back_inserter
+#include <limits>      // numeric_limits
+#include <sstream>     // stringstream
+#include <type_traits> // is_floating_point
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+
+namespace snapshot {
+struct Access;
+} // namespace snapshot
+
+/**
+ *  \brief Bounded memory quantile sketch (merging t-digest)
+ *
+ *  The samples are summarized by a sorted list of centroids (mean, weight).
+ *  Centroids close to the tails are kept small while centroids close to the
+ *  median may absorb more samples, which makes extreme quantiles (p99, p999)
+ *  accurate. The size of the centroids is bounded by the k1 scale function:
+ *  k(q) = compression / (2 pi) * asin(2q - 1)
+ *
+ *  New samples are appended to a buffer, which is merged into the centroids
+ *  when full (or when a quantile is requested). All the memory is allocated by
+ *  the constructor.
+ *
+ *  See: Dunning, T. & Ertl, O. "Computing extremely accurate quantiles using
+ *  t-digests"
+ *
+ *  \notes This class is not thread safe (even the const methods) !
+ *
+ *  \tparam T The measurement sample type (floating point)
+ */
+template <class T = double> class TDigest {
+  static_assert(std::is_floating_point<T>::value,
+                "TDigest only supports floating point samples");
+
+public:
+  /**
+   *  \brief Constructor
+   *  \param[in] compression The compression factor: higher means more accurate
+   *                         quantiles, more memory and slower updates (the
+   *                         number of centroids is ~compression)
+   */
+  explicit TDigest(const std::size_t compression = 100)
+      : compression_(static_cast<T>(std::max<std::size_t>(compression, 10))),
+        number_of_measurements_(0),
+        min_(std::numeric_limits<T>::infinity()),
+        max_(-std::numeric_limits<T>::infinity()) {
+    const auto max_centroids = 2 * static_cast<std::size_t>(compression_);
+    const auto buffer_size = 5 * static_cast<std::size_t>(compression_);
+    centroids_.reserve(max_centroids);
+    buffer_.reserve(buffer_size);
+    merged_.reserve(max_centroids + buffer_size);
+  }
+
+  /**
+   *  \brief Reset the sketch (N set to 0)
+   */
+  void reset() noexcept {
+    centroids_.clear();
+    buffer_.clear();
+    number_of_measurements_ = 0;
+    min_ = std::numeric_limits<T>::infinity();
+    max_ = -std::numeric_limits<T>::infinity();
+  }
+
+  /**
+   *  \brief Get the compression factor used
+   *  \return std::size_t The compression
+   */
+  std::size_t getCompression() const noexcept {
+    return static_cast<std::size_t>(compression_);
+  }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the number of centroids currently used to summarize the samples
+   *  \return std::size_t The number of centroids
+   */
+  std::size_t getNumberOfCentroids() const {
+    flush();
+    return centroids_.size();
+  }
+
+  /**
+   *  \brief Get the smallest measurement
+   *  \return T The min (+inf when N = 0)
+   */
+  T getMin() const noexcept { return min_; }
+
+  /**
+   *  \brief Get the biggest measurement
+   *  \return T The max (-inf when N = 0)
+   */
+  T getMax() const noexcept { return max_; }
+
+  /**
+   *  \brief Update the sketch with the new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  void updateWith(const T &new_data) {
+    add(Centroid{new_data, 1});
+    number_of_measurements_++;
+    min_ = std::min(min_, new_data);
+    max_ = std::max(max_, new_data);
+  }
+
+  /**
+   *  \brief Merge the sketch of an other set of measurements
+   *  \param[in] other The sketch to merge into *this
+   *  \return TDigest& *this
+   */
+  TDigest &merge(const TDigest &other) {
+    assert(&other != this && "Can't merge a TDigest with itself");
+    for (const auto &centroid : other.centroids_)
+      add(centroid);
+    for (const auto &centroid : other.buffer_)
+      add(centroid);
+
+    number_of_measurements_ += other.number_of_measurements_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    return *this;
+  }
+
+  /**
+   *  \brief Estimate the quantile q
+   *  \notes Number of measurement must be != 0
+   *  \param[in] q The quantile requested, in [0, 1] (0.5 for the median)
+   *  \return T The estimated value below which a fraction q of the
+   *          measurements are
+   */
+  T quantile(const T q) const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute a quantile");
+    flush();
+
+    if (q <= 0)
+      return min_;
+    if (q >= 1)
+      return max_;
+    if (centroids_.size() == 1)
+      return centroids_.front().mean;
+
+    const auto index = q * number_of_measurements_;
+
+    // Left tail: interpolate between the min and the first centroid
+    const auto &first = centroids_.front();
+    if (index < first.weight / 2)
+      return min_ + (first.mean - min_) * index / (first.weight / 2);
+
+    // Interpolate between the centers of two adjacent centroids
+    T cumulated = first.weight / 2;
+    for (std::size_t i = 0; i + 1 < centroids_.size(); ++i) {
+      const auto &lhs = centroids_[i];
+      const auto &rhs = centroids_[i + 1];
+      const auto gap = (lhs.weight + rhs.weight) / 2;
+      if (cumulated + gap > index)
+        return lhs.mean + (rhs.mean - lhs.mean) * (index - cumulated) / gap;
+      cumulated += gap;
+    }
+
+    // Right tail: interpolate between the last centroid and the max
+    const auto &last = centroids_.back();
+    return last.mean +
+           (max_ - last.mean) * std::min<T>(1, (index - cumulated) /
+                                                   (last.weight / 2));
+  }
+
+private:
+  friend struct snapshot::Access; /*!< Binary (de)serialization */
+
+  struct Centroid {
+    T mean;
+    T weight;
+
+    constexpr bool operator<(const Centroid &other) const noexcept {
+      return mean < other.mean;
+    }
+  };
+
+  void add(const Centroid &centroid) {
+    if (buffer_.size() == buffer_.capacity())
+      flush();
+    buffer_.push_back(centroid);
+  }
+
+  /// k1 scale function, and its inverse
+  T scale(const T q) const noexcept {
+    return compression_ / (2 * pi) * std::asin(2 * q - 1);
+  }
+  T inverseScale(const T k) const noexcept {
+    return (std::sin(k * (2 * pi) / compression_) + 1) / 2;
+  }
+
+  /// Quantile up to which a centroid starting at q may grow (k(q) + 1),
+  /// clamped to the top of the scale (k(1) = compression / 4)
+  T quantileLimit(const T q) const noexcept {
+    const auto k = scale(q) + 1;
+    return k < compression_ / 4 ? inverseScale(k) : T{1};
+  }
+
+  /// Merge the buffered samples into the centroids
+  void flush() const {
+    if (buffer_.empty())
+      return;
+
+    std::sort(buffer_.begin(), buffer_.end());
+
+    merged_.clear();
+    std::merge(centroids_.cbegin(), centroids_.cend(), buffer_.cbegin(),
+               buffer_.cend(), std::back_inserter(merged_));
+    buffer_.clear();
+
+    T total_weight = 0;
+    for (const auto &centroid : merged_)
+      total_weight += centroid.weight;
+
+    centroids_.clear();
+    auto current = merged_.front();
+    T weight_so_far = 0;
+    T weight_limit = total_weight * quantileLimit(0);
+
+    for (auto it = std::next(merged_.cbegin()); it != merged_.cend(); ++it) {
+      if (weight_so_far + current.weight + it->weight <= weight_limit) {
+        current.weight += it->weight;
+        current.mean += (it->mean - current.mean) * it->weight / current.weight;
+      } else {
+        weight_so_far += current.weight;
+        weight_limit =
+            total_weight * quantileLimit(weight_so_far / total_weight);
+        centroids_.push_back(current);
+        current = *it;
+      }
+    }
+    centroids_.push_back(current);
+  }
+
+  static constexpr T pi = static_cast<T>(3.14159265358979323846L);
+
+  T compression_; /*!< Hold the compression factor */
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  T min_;                      /*!< Hold the smallest measurement */
+  T max_;                      /*!< Hold the biggest measurement */
+  mutable std::vector<Centroid> centroids_; /*!< Sorted centroids */
+  mutable std::vector<Centroid> buffer_;    /*!< Samples not merged yet */
+  mutable std::vector<Centroid> merged_;    /*!< Scratch space for flush() */
+};
+
+/**
+ *  \brief Format a TDigest to a string
+ *  \param[in] digest The TDigest object to format
+ *  \return std::string The string format of the TDigest
+ */
+template <class T> std::string format(const TDigest<T> &digest) {
+  std::stringstream output;
+  const auto n = digest.getNumberOfMeasurements();
+  output << "Quantiles [N = " << n << "]";
+
+  if (n == 0) {
+    output << " -> Not enough samples yet";
+  } else {
+    output << "\nMin : " << digest.getMin();
+    output << "\np50 : " << digest.quantile(0.5);
+    output << "\np90 : " << digest.quantile(0.9);
+    output << "\np99 : " << digest.quantile(0.99);
+    output << "\np999: " << digest.quantile(0.999);
+    output << "\nMax : " << digest.getMax();
+  }
+
+  return output.str();
+}
+
+} // namespace stats
+} // namespace arthoolbox
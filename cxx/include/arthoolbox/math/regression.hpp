@@ -0,0 +1,204 @@
+#pragma once
+/**
+ *   \file regression.hpp
+ *   \brief Contains tools to perform online linear regression/correlation
+ */
+
+#include <cassert> // assert
+#include <cmath>   // sqrt
+#include <cstdlib> // std::size_t
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Enables online least squares linear regression (y = a * x + b) and
+ *  Pearson correlation between two variables
+ *
+ *  From the previous means (Mx_n-1, My_n-1), a new measurement (x_n, y_n)
+ *  updates the sums of squares and the co-moment with:
+ *  Mx_n = Mx_n-1 + (x_n - Mx_n-1)/n
+ *  My_n = My_n-1 + (y_n - My_n-1)/n
+ *  Sxx_n = Sxx_n-1 + (x_n - Mx_n-1) * (x_n - Mx_n)
+ *  Syy_n = Syy_n-1 + (y_n - My_n-1) * (y_n - My_n)
+ *  Cxy_n = Cxy_n-1 + (x_n - Mx_n-1) * (y_n - My_n)
+ *
+ *  The regression and the correlation are then computed on query:
+ *  slope = Cxy / Sxx
+ *  intercept = My - slope * Mx
+ *  correlation = Cxy / sqrt(Sxx * Syy)
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Covariance, Online)
+ *
+ *  \notes This class is not thread safe, use one accumulator per thread and
+ *  merge() them.
+ *
+ *  \tparam T The type of the samples (and of the statistics)
+ */
+template <class T> class RecurrentRegression {
+public:
+  //! Default constructor
+  RecurrentRegression()
+      : number_of_measurements_(0), mean_x_(), mean_y_(), sum_square_x_(),
+        sum_square_y_(), co_moment_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  void reset() noexcept { *this = RecurrentRegression(); };
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed mean of x
+   *  \return T The mean computed
+   */
+  T getMeanX() const noexcept { return mean_x_; }
+
+  /**
+   *  \brief Get the currently computed mean of y
+   *  \return T The mean computed
+   */
+  T getMeanY() const noexcept { return mean_y_; }
+
+  /**
+   *  \brief Get the currently computed variance of x
+   *  \notes Number of measurement must be != 0
+   *  \return T the variance computed
+   */
+  T getVarianceX() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return sum_square_x_ / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed variance of y
+   *  \notes Number of measurement must be != 0
+   *  \return T the variance computed
+   */
+  T getVarianceY() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return sum_square_y_ / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the currently computed covariance between x and y
+   *  \notes Number of measurement must be != 0
+   *  \return T the covariance computed
+   */
+  T getCovariance() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the covariance");
+    return co_moment_ / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the slope a of the least squares line y = a * x + b
+   *  \notes Number of measurement must be > 1, with different values of x
+   *  \return T the slope computed
+   */
+  T getSlope() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the slope");
+    return co_moment_ / sum_square_x_;
+  }
+
+  /**
+   *  \brief Get the intercept b of the least squares line y = a * x + b
+   *  \notes Number of measurement must be > 1, with different values of x
+   *  \return T the intercept computed
+   */
+  T getIntercept() const { return mean_y_ - getSlope() * mean_x_; }
+
+  /**
+   *  \brief Get the Pearson correlation coefficient between x and y
+   *  \notes Number of measurement must be > 1, with different values of x
+   *  and y
+   *  \return T the correlation computed, within [-1, 1]
+   */
+  T getCorrelation() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the correlation");
+    using std::sqrt;
+    return co_moment_ / sqrt(sum_square_x_ * sum_square_y_);
+  }
+
+  /**
+   *  \brief Update the computed stats with the new measurement
+   *  \param[in] x, y The new measurement
+   */
+  void updateWith(const T &x, const T &y) noexcept {
+    number_of_measurements_++;
+
+    const T delta_x = x - mean_x_;
+    const T delta_y = y - mean_y_;
+    mean_x_ += delta_x / number_of_measurements_;
+    mean_y_ += delta_y / number_of_measurements_;
+
+    const T new_delta_y = y - mean_y_;
+    sum_square_x_ += delta_x * (x - mean_x_);
+    sum_square_y_ += delta_y * new_delta_y;
+    co_moment_ += delta_x * new_delta_y;
+  }
+
+  /**
+   *  \brief Merge the stats computed over an other set of measurements
+   *
+   *  The means, sums of squares and co-moment are merged using
+   *  merge_recurring_mean, merge_recurring_sum_square and
+   *  merge_recurring_co_moment.
+   *
+   *  \param[in] other The statistics to merge into *this
+   *  \return RecurrentRegression& *this
+   */
+  RecurrentRegression &merge(const RecurrentRegression &other) noexcept {
+    if (other.number_of_measurements_ == 0)
+      return *this;
+
+    if (number_of_measurements_ == 0) {
+      *this = other;
+      return *this;
+    }
+
+    const auto n_a = number_of_measurements_;
+    const auto n_b = other.number_of_measurements_;
+
+    // Sums first, they depend on the means before the merge
+    sum_square_x_ = merge_recurring_sum_square(
+        sum_square_x_, mean_x_, n_a, other.sum_square_x_, other.mean_x_, n_b);
+    sum_square_y_ = merge_recurring_sum_square(
+        sum_square_y_, mean_y_, n_a, other.sum_square_y_, other.mean_y_, n_b);
+    co_moment_ = merge_recurring_co_moment(co_moment_, mean_x_, mean_y_, n_a,
+                                           other.co_moment_, other.mean_x_,
+                                           other.mean_y_, n_b);
+
+    mean_x_ = merge_recurring_mean(mean_x_, n_a, other.mean_x_, n_b);
+    mean_y_ = merge_recurring_mean(mean_y_, n_a, other.mean_y_, n_b);
+
+    number_of_measurements_ = n_a + n_b;
+    return *this;
+  }
+
+private:
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment N */
+  T mean_x_;                   /*!< Hold the currently computed mean of x */
+  T mean_y_;                   /*!< Hold the currently computed mean of y */
+  T sum_square_x_;             /*!< Hold the sum of squares of x */
+  T sum_square_y_;             /*!< Hold the sum of squares of y */
+  T co_moment_;                /*!< Hold the co-moment of x and y */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,239 @@
+#pragma once
+/**
+ *   \file sharded_statistics.hpp
+ *   \brief Contains a statistics accumulator that can be updated concurrently
+ */
+
+#include <atomic>  // atomic, atomic_thread_fence
+#include <cstdlib> // std::size_t
+#include <mutex>   // mutex, lock_guard
+#include <thread>  // hardware_concurrency
+#include <vector>
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+namespace details {
+
+/**
+ *  \brief Process wide registry of the thread slots
+ *
+ *  Each running thread owns a distinct slot index, the smallest one available
+ *  when the thread first asks for it. The slot is released when the thread
+ *  exits and reused by the next thread: with K running threads, all the
+ *  indexes are < K, whatever the number of threads created before.
+ */
+class ThreadSlots {
+public:
+  /// Get the slot index of the calling thread (acquired on first use)
+  static std::size_t current() noexcept {
+    thread_local const Slot slot;
+    return slot.index;
+  }
+
+private:
+  struct Slot {
+    Slot() : index(acquire()) {}
+    ~Slot() { release(index); }
+
+    std::size_t index; /*!< Hold the slot index owned by the thread */
+  };
+
+  static std::size_t acquire() {
+    std::lock_guard<std::mutex> lock(mutex());
+    auto &used = slots();
+    std::size_t index = 0;
+    while (index < used.size() && used[index])
+      ++index;
+
+    if (index == used.size())
+      used.push_back(true);
+    else
+      used[index] = true;
+    return index;
+  }
+
+  static void release(const std::size_t index) {
+    std::lock_guard<std::mutex> lock(mutex());
+    slots()[index] = false;
+  }
+
+  static std::mutex &mutex() {
+    static std::mutex instance;
+    return instance;
+  }
+
+  static std::vector<bool> &slots() {
+    static std::vector<bool> instance;
+    return instance;
+  }
+};
+
+} // namespace details
+
+/**
+ *  \brief Online recurrent statistics that can be updated by multiple threads
+ *
+ *  Each thread owns a shard (a cache line aligned N/mean/sum square triplet),
+ *  chosen by its details::ThreadSlots index. Slots are recycled when threads
+ *  exit, so as long as there are no more running threads than shards, each
+ *  thread has a shard of its own: updateWith() is wait free and never touches
+ *  the cache line of an other thread.
+ *
+ *  Each owned shard has a single writer and is protected by a seqlock: the
+ *  writer makes the sequence odd while updating (plain stores, no CAS),
+ *  readers (snapshot()) retry until they read an even and unchanged sequence.
+ *  Readers never block writers.
+ *
+ *  Threads whose slot is >= the number of shards share an extra overflow
+ *  shard, whose writers are serialized by a spin lock.
+ *
+ *  reset() doesn't write into the shards: it starts a new epoch, and each
+ *  shard is cleared by its writer on its next update (and ignored by
+ *  snapshot() until then). Measurements recorded concurrently with reset()
+ *  may be dropped.
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam U The mean type (must be trivially copyable)
+ *  \tparam S The variance type (must be trivially copyable)
+ */
+template <class T, class U = T, class S = U> class ShardedStatistics {
+public:
+  /**
+   *  \brief Construct the accumulator
+   *  \param[in] shard_count The number of shards, i.e. of threads updating
+   *                         concurrently without sharing (0 = hardware
+   *                         concurrency)
+   */
+  explicit ShardedStatistics(const std::size_t shard_count = 0)
+      : shards_((shard_count != 0 ? shard_count : defaultShardCount()) + 1),
+        epoch_(0), overflow_lock_(false) {}
+
+  ShardedStatistics(const ShardedStatistics &) = delete;
+  ShardedStatistics &operator=(const ShardedStatistics &) = delete;
+
+  /**
+   *  \brief Get the number of shards used (without the overflow shard)
+   *  \return std::size_t The number of shards
+   */
+  std::size_t getNumberOfShards() const noexcept { return shards_.size() - 1; }
+
+  /**
+   *  \brief Update the shard of the calling thread with a new measurement
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  void updateWith(const T &new_data) noexcept {
+    const auto epoch = epoch_.load(std::memory_order_acquire);
+    const auto slot = details::ThreadSlots::current();
+    if (slot < getNumberOfShards()) {
+      shards_[slot].write(new_data, epoch);
+      return;
+    }
+
+    while (overflow_lock_.exchange(true, std::memory_order_acquire))
+      ;
+    shards_.back().write(new_data, epoch);
+    overflow_lock_.store(false, std::memory_order_release);
+  }
+
+  /**
+   *  \brief Reset all the shards (N set to 0)
+   */
+  void reset() noexcept { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+  /**
+   *  \brief Aggregate all the shards into a single RecurrentStatistics
+   *
+   *  Each shard is read consistently, but shards are not read at the same
+   *  instant: measurements added during the snapshot may or may not be taken
+   *  into account.
+   *
+   *  \return RecurrentStatistics The merged statistics of all the shards
+   */
+  RecurrentStatistics<T, U, S> snapshot() const noexcept {
+    const auto epoch = epoch_.load(std::memory_order_acquire);
+    RecurrentStatistics<T, U, S> stats;
+    for (const auto &shard : shards_)
+      stats.merge(shard.read(epoch));
+    return stats;
+  }
+
+private:
+  /// Assumed size of a cache line, to avoid false sharing between shards
+  static constexpr std::size_t cache_line_size = 64;
+
+  struct alignas(cache_line_size) Shard {
+    std::atomic<std::size_t> sequence{0};
+    std::atomic<std::size_t> epoch{0};
+    std::atomic<std::size_t> number_of_measurements{0};
+    std::atomic<U> mean{U{}};
+    std::atomic<S> sum_square{S{}};
+
+    /// Update the shard, must only be called by its (single) writer
+    void write(const T &new_data, const std::size_t current_epoch) noexcept {
+      const auto locked = sequence.load(std::memory_order_relaxed) + 1;
+      sequence.store(locked, std::memory_order_relaxed);
+      // Order the odd sequence before the (relaxed) data stores that follow,
+      // otherwise a reader could see the new data with the old sequence
+      std::atomic_thread_fence(std::memory_order_release);
+
+      // First update since a reset(): start from empty statistics
+      std::size_t n = 1;
+      U old_mean{};
+      S old_sum_square{};
+      if (epoch.load(std::memory_order_relaxed) == current_epoch) {
+        n += number_of_measurements.load(std::memory_order_relaxed);
+        old_mean = mean.load(std::memory_order_relaxed);
+        old_sum_square = sum_square.load(std::memory_order_relaxed);
+      } else {
+        epoch.store(current_epoch, std::memory_order_relaxed);
+      }
+
+      const auto new_mean = update_recurring_mean(new_data, old_mean, n);
+      number_of_measurements.store(n, std::memory_order_relaxed);
+      mean.store(new_mean, std::memory_order_relaxed);
+      sum_square.store(update_recurring_sum_square(new_data, old_sum_square,
+                                                   new_mean, old_mean),
+                       std::memory_order_relaxed);
+
+      sequence.store(locked + 1, std::memory_order_release);
+    }
+
+    /// Read a consistent copy of the shard (empty if not of current_epoch)
+    RecurrentStatistics<T, U, S>
+    read(const std::size_t current_epoch) const noexcept {
+      while (true) {
+        const auto before = sequence.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+          continue;
+
+        const auto e = epoch.load(std::memory_order_relaxed);
+        const auto n = number_of_measurements.load(std::memory_order_relaxed);
+        const auto m = mean.load(std::memory_order_relaxed);
+        const auto ss = sum_square.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != before)
+          continue;
+
+        if (e != current_epoch)
+          return RecurrentStatistics<T, U, S>();
+        return RecurrentStatistics<T, U, S>(n, m, ss);
+      }
+    }
+  };
+
+  static std::size_t defaultShardCount() noexcept {
+    const auto hardware = std::thread::hardware_concurrency();
+    return hardware != 0 ? hardware : 1;
+  }
+
+  std::vector<Shard> shards_;       /*!< Hold the shards, overflow last */
+  std::atomic<std::size_t> epoch_;  /*!< Hold the current reset epoch */
+  std::atomic<bool> overflow_lock_; /*!< Hold the overflow shard lock */
+};
+
+} // namespace stats
+} // namespace arthoolbox
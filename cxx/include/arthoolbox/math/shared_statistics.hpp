@@ -0,0 +1,262 @@
+#pragma once
+/**
+ *   \file shared_statistics.hpp
+ *   \brief Contains tools to publish statistics to other processes through a
+ *   POSIX shared memory region
+ *
+ *   The region contains a 64 bits sequence number followed by a
+ *   snapshot::Kind::Statistics snapshot (see snapshot.hpp), stored as 64 bits
+ *   words. The publisher (single writer) makes the sequence odd while writing
+ *   the words, readers retry until they read an even and unchanged sequence
+ *   (seqlock): publishing never blocks nor performs any syscall. Readers give
+ *   up after a bounded number of attempts, so a publisher that died while
+ *   writing (odd sequence left behind) can't block them.
+ */
+
+#include <atomic>       // atomic, atomic_thread_fence
+#include <cerrno>       // errno
+#include <cstdint>      // uint64_t
+#include <cstdlib>      // std::size_t
+#include <string>       // string
+#include <system_error> // system_error, errc
+#include <utility>      // move
+
+#include <fcntl.h>    // O_* constants
+#include <sys/mman.h> // shm_open, mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // ftruncate, close
+
+#include "arthoolbox/math/snapshot.hpp"
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+namespace details {
+
+/// Layout of the shared memory region
+struct SharedStatisticsRegion {
+  static constexpr std::size_t words =
+      (snapshot::header_size + snapshot::statistics_payload_size + 7) / 8;
+
+  std::atomic<std::uint64_t> sequence;
+  std::atomic<std::uint64_t> snapshot[words];
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared memory atomics must be lock free");
+
+[[noreturn]] inline void throwErrno(const std::string &what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// Close fd, preserving errno, and throw the error of what
+[[noreturn]] inline void closeAndThrowErrno(const int fd,
+                                            const std::string &what) {
+  const int error = errno;
+  ::close(fd);
+  errno = error;
+  throwErrno(what);
+}
+
+} // namespace details
+
+/**
+ *  \brief Publish RecurrentStatistics into a named POSIX shared memory region
+ *
+ *  The region (shm_open name, e.g. "/my_stats") is created by the constructor
+ *  and removed by the destructor (unless an other region has been created with
+ *  the same name since then). A region left behind by a publisher that
+ *  crashed is reused and reset.
+ *
+ *  \notes Only one thread may publish at a time, and only one publisher may
+ *         use a given name.
+ */
+class StatisticsPublisher {
+public:
+  /**
+   *  \brief Create (or reset) the shared memory region
+   *  \param[in] name The shared memory object name, starting with a '/'
+   *  \throw std::system_error If the region can't be created/mapped
+   */
+  explicit StatisticsPublisher(std::string name) : name_(std::move(name)) {
+    const int fd = ::shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd == -1)
+      details::throwErrno("shm_open(" + name_ + ")");
+
+    struct stat status;
+    if (::fstat(fd, &status) == -1)
+      details::closeAndThrowErrno(fd, "fstat(" + name_ + ")");
+    device_ = status.st_dev;
+    inode_ = status.st_ino;
+
+    if (::ftruncate(fd, sizeof(details::SharedStatisticsRegion)) == -1)
+      details::closeAndThrowErrno(fd, "ftruncate(" + name_ + ")");
+
+    void *address = ::mmap(nullptr, sizeof(details::SharedStatisticsRegion),
+                           PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+      details::closeAndThrowErrno(fd, "mmap(" + name_ + ")");
+    ::close(fd);
+
+    // ftruncate() doesn't clear an existing region (e.g. left by a publisher
+    // that crashed, maybe with an odd sequence): reset it, no snapshot yet
+    region_ = static_cast<details::SharedStatisticsRegion *>(address);
+    for (auto &word : region_->snapshot)
+      word.store(0, std::memory_order_relaxed);
+    region_->sequence.store(0, std::memory_order_release);
+  }
+
+  StatisticsPublisher(const StatisticsPublisher &) = delete;
+  StatisticsPublisher &operator=(const StatisticsPublisher &) = delete;
+
+  ~StatisticsPublisher() noexcept {
+    ::munmap(region_, sizeof(details::SharedStatisticsRegion));
+
+    // Only remove the name if it still designates the region created
+    const int fd = ::shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+      return;
+
+    struct stat status;
+    const bool is_ours = (::fstat(fd, &status) == 0) and
+                         (status.st_dev == device_) and
+                         (status.st_ino == inode_);
+    ::close(fd);
+    if (is_ours)
+      ::shm_unlink(name_.c_str());
+  }
+
+  /**
+   *  \brief Get the shared memory object name
+   *  \return std::string const& The name
+   */
+  const std::string &getName() const noexcept { return name_; }
+
+  /**
+   *  \brief Publish the current value of the statistics
+   *  \param[in] stats The statistics to publish
+   */
+  template <class T, class U, class S>
+  void publish(const RecurrentStatistics<T, U, S> &stats) noexcept {
+    std::uint64_t words[details::SharedStatisticsRegion::words] = {};
+    snapshot::write(stats, reinterpret_cast<char *>(words));
+
+    const auto sequence = region_->sequence.load(std::memory_order_relaxed);
+    region_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < details::SharedStatisticsRegion::words; ++i)
+      region_->snapshot[i].store(words[i], std::memory_order_relaxed);
+
+    region_->sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+private:
+  std::string name_;                        /*!< Hold the shm name */
+  dev_t device_;                            /*!< Hold the region device */
+  ino_t inode_;                             /*!< Hold the region inode */
+  details::SharedStatisticsRegion *region_; /*!< Hold the mapped region */
+};
+
+/**
+ *  \brief Read RecurrentStatistics published by a StatisticsPublisher, from
+ *  an other process (or thread)
+ */
+class StatisticsSubscriber {
+public:
+  /**
+   *  \brief Map the shared memory region (read only)
+   *  \param[in] name The shared memory object name, starting with a '/'
+   *  \throw std::system_error If the region doesn't exist, is too small (not
+   *         created by a StatisticsPublisher) or can't be mapped
+   */
+  explicit StatisticsSubscriber(const std::string &name) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1)
+      details::throwErrno("shm_open(" + name + ")");
+
+    // Mapping past the end of the object would SIGBUS on the first read
+    struct stat status;
+    if (::fstat(fd, &status) == -1)
+      details::closeAndThrowErrno(fd, "fstat(" + name + ")");
+    if (static_cast<std::size_t>(status.st_size) <
+        sizeof(details::SharedStatisticsRegion)) {
+      ::close(fd);
+      throw std::system_error(
+          std::make_error_code(std::errc::invalid_argument),
+          "StatisticsSubscriber(" + name + "): region too small");
+    }
+
+    void *address = ::mmap(nullptr, sizeof(details::SharedStatisticsRegion),
+                           PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED)
+      details::closeAndThrowErrno(fd, "mmap(" + name + ")");
+    ::close(fd);
+
+    region_ = static_cast<const details::SharedStatisticsRegion *>(address);
+  }
+
+  StatisticsSubscriber(const StatisticsSubscriber &) = delete;
+  StatisticsSubscriber &operator=(const StatisticsSubscriber &) = delete;
+
+  ~StatisticsSubscriber() noexcept {
+    ::munmap(const_cast<details::SharedStatisticsRegion *>(region_),
+             sizeof(details::SharedStatisticsRegion));
+  }
+
+  /**
+   *  \brief Get the number of snapshots published so far
+   *  \return std::uint64_t The number of publish() calls
+   */
+  std::uint64_t getNumberOfPublications() const noexcept {
+    return region_->sequence.load(std::memory_order_acquire) / 2;
+  }
+
+  /**
+   *  \brief Read a consistent copy of the latest statistics published
+   *  \param[out] stats        Set to the statistics (N = 0 when nothing has
+   *                           been published yet)
+   *  \param[in]  max_attempts The number of attempts before giving up, while
+   *                           the publisher keeps writing (or died writing)
+   *  \return bool True on success, stats is left untouched otherwise
+   */
+  bool read(RecurrentStatistics<double, double> &stats,
+            const std::size_t max_attempts = 1024) const noexcept {
+    std::uint64_t words[details::SharedStatisticsRegion::words];
+    for (std::size_t attempt = 0; attempt < max_attempts; ++attempt) {
+      const auto before = region_->sequence.load(std::memory_order_acquire);
+      if ((before & 1) != 0)
+        continue;
+
+      if (before == 0) {
+        stats = RecurrentStatistics<double, double>();
+        return true;
+      }
+
+      for (std::size_t i = 0; i < details::SharedStatisticsRegion::words; ++i)
+        words[i] = region_->snapshot[i].load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (region_->sequence.load(std::memory_order_relaxed) != before)
+        continue;
+
+      const snapshot::StatisticsView view(
+          reinterpret_cast<const char *>(words), sizeof(words));
+      const auto copy = view.toStatistics<double>();
+      if (not copy.has_value())
+        return false;
+
+      stats = *copy;
+      return true;
+    }
+
+    return false;
+  }
+
+private:
+  const details::SharedStatisticsRegion *region_; /*!< Hold the region */
+};
+
+} // namespace stats
+} // namespace arthoolbox
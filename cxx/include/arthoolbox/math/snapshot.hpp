@@ -0,0 +1,551 @@
+#pragma once
+/**
+ *   \file snapshot.hpp
+ *   \brief Contains a compact binary snapshot format of the statistics, to
+ *   ship them across processes
+ *
+ *   All the values are little endian, floating points are IEEE 754 binary64.
+ *   A snapshot is made of a 16 bytes header followed by a payload:
+ *
+ *   Header:
+ *   | Offset | Type | Content                          |
+ *   |--------+------+----------------------------------|
+ *   |      0 | u32  | magic ('A' 'R' 'T' 'S')          |
+ *   |      4 | u16  | version (snapshot::version)      |
+ *   |      6 | u16  | kind (snapshot::Kind)            |
+ *   |      8 | u64  | payload size, in bytes           |
+ *
+ *   Kind::Statistics payload (RecurrentStatistics):
+ *   | 0 u64 N | 8 f64 mean | 16 f64 sum square |
+ *
+ *   Kind::LogHistogram payload:
+ *   | 0 u32 precision | 4 u32 bucket count B | 8 u64 max value | 16 u64 N |
+ *   | 24 u64 min | 32 u64 max | 40 u64 counts[B] |
+ *
+ *   Kind::TDigest payload:
+ *   | 0 u32 compression | 4 u32 centroid count C | 8 u64 N | 16 f64 min |
+ *   | 24 f64 max | 32 {f64 mean, f64 weight}[C] |
+ *
+ *   The views (StatisticsView, LogHistogramView, TDigestView) read the values
+ *   directly from the received buffer, without copying nor allocating. The
+ *   buffers may come from an other process: isValid() checks the whole
+ *   content before anything is deserialized.
+ */
+
+#include <algorithm> // min, max
+#include <cmath>     // isfinite
+#include <cstdint>   // uint*_t
+#include <cstdlib>   // std::size_t
+#include <cstring>   // memcpy
+#include <optional>  // optional
+#include <utility>   // pair
+#include <vector>
+
+#include "arthoolbox/math/histogram.hpp"
+#include "arthoolbox/math/quantile.hpp"
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+namespace snapshot {
+
+/// Type of statistics contained inside a snapshot
+enum class Kind : std::uint16_t {
+  Statistics = 1,   /*!< RecurrentStatistics */
+  LogHistogram = 2, /*!< LogHistogram */
+  TDigest = 3,      /*!< TDigest */
+};
+
+constexpr std::uint32_t magic = 0x53545241; /*!< 'A' 'R' 'T' 'S' */
+constexpr std::uint16_t version = 1;        /*!< Current format version */
+constexpr std::size_t header_size = 16;     /*!< Size of the header */
+
+/// Biggest TDigest compression accepted, bounding the memory allocated
+constexpr std::size_t max_tdigest_compression = 10000;
+
+namespace details {
+
+template <class U> inline void store(char *out, U value) noexcept {
+  for (std::size_t i = 0; i < sizeof(U); ++i)
+    out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+inline void store(char *out, double value) noexcept {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  store(out, bits);
+}
+
+template <class U> inline U load(const char *in) noexcept {
+  U value = 0;
+  for (std::size_t i = 0; i < sizeof(U); ++i)
+    value |= static_cast<U>(static_cast<unsigned char>(in[i])) << (8 * i);
+  return value;
+}
+
+inline double loadDouble(const char *in) noexcept {
+  const auto bits = load<std::uint64_t>(in);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline char *writeHeader(char *out, const Kind kind,
+                         const std::uint64_t payload_size) noexcept {
+  store(out, magic);
+  store(out + 4, version);
+  store(out + 6, static_cast<std::uint16_t>(kind));
+  store(out + 8, payload_size);
+  return out + header_size;
+}
+
+} // namespace details
+
+/**
+ *  \brief Gives access to the internals of the statistics to (de)serialize
+ */
+struct Access {
+  static const std::vector<LogHistogram::count_type> &
+  counts(const LogHistogram &histogram) {
+    return histogram.counts_;
+  }
+
+  static void mergeCounts(LogHistogram &histogram, const char *counts,
+                          const LogHistogram::count_type n,
+                          const LogHistogram::value_type min,
+                          const LogHistogram::value_type max) {
+    for (auto &count : histogram.counts_) {
+      count += details::load<std::uint64_t>(counts);
+      counts += 8;
+    }
+    histogram.number_of_measurements_ += n;
+    histogram.min_ = std::min(histogram.min_, min);
+    histogram.max_ = std::max(histogram.max_, max);
+  }
+
+  template <class T, class F>
+  static void forEachCentroid(const TDigest<T> &digest, F &&f) {
+    digest.flush();
+    for (const auto &centroid : digest.centroids_)
+      f(centroid.mean, centroid.weight);
+  }
+
+  template <class T>
+  static void mergeCentroid(TDigest<T> &digest, const T mean, const T weight) {
+    digest.add({mean, weight});
+  }
+
+  template <class T>
+  static void mergeSummary(TDigest<T> &digest, const std::size_t n,
+                           const T min, const T max) {
+    digest.number_of_measurements_ += n;
+    digest.min_ = std::min(digest.min_, min);
+    digest.max_ = std::max(digest.max_, max);
+  }
+};
+
+/**
+ *  \brief Untyped view over a received snapshot buffer
+ */
+class View {
+public:
+  /**
+   *  \brief Constructor (no copy, the buffer must outlive the view)
+   *  \param[in] data The beginning of the buffer
+   *  \param[in] size The size of the buffer, in bytes
+   */
+  View(const char *data, const std::size_t size) noexcept
+      : data_(data), size_(size) {}
+
+  /**
+   *  \brief Check the header (magic, version and size)
+   *  \return bool True when the header is valid and the whole snapshot fits
+   *          inside the buffer
+   */
+  bool isValid() const noexcept {
+    return size_ >= header_size &&
+           details::load<std::uint32_t>(data_) == magic &&
+           details::load<std::uint16_t>(data_ + 4) == version &&
+           getPayloadSize() <= size_ - header_size;
+  }
+
+  /**
+   *  \brief Get the kind of statistics contained (the header must be valid)
+   *  \return Kind The kind of the snapshot
+   */
+  Kind getKind() const noexcept {
+    return static_cast<Kind>(details::load<std::uint16_t>(data_ + 6));
+  }
+
+  /**
+   *  \brief Get the size of the payload (the header must be valid)
+   *  \return std::uint64_t The payload size, in bytes
+   */
+  std::uint64_t getPayloadSize() const noexcept {
+    return details::load<std::uint64_t>(data_ + 8);
+  }
+
+  /**
+   *  \brief Get the total size of the snapshot (the header must be valid),
+   *         i.e. the offset of the next snapshot inside a stream
+   *  \return std::size_t The header + payload size, in bytes
+   */
+  std::size_t getSize() const noexcept {
+    return header_size + static_cast<std::size_t>(getPayloadSize());
+  }
+
+protected:
+  const char *payload() const noexcept { return data_ + header_size; }
+
+  bool isValid(const Kind kind,
+               const std::uint64_t min_payload) const noexcept {
+    return isValid() && getKind() == kind && getPayloadSize() >= min_payload;
+  }
+
+private:
+  const char *data_; /*!< Hold the beginning of the buffer */
+  std::size_t size_; /*!< Hold the size of the buffer */
+};
+
+/// Payload size of Kind::Statistics
+constexpr std::size_t statistics_payload_size = 24;
+
+/**
+ *  \brief Get the size needed to serialize a RecurrentStatistics
+ *  \return std::size_t The size, in bytes
+ */
+template <class T, class U, class S>
+constexpr std::size_t size(const RecurrentStatistics<T, U, S> &) noexcept {
+  return header_size + statistics_payload_size;
+}
+
+/**
+ *  \brief Serialize a RecurrentStatistics (mean and sum square as binary64)
+ *  \param[in] stats The RecurrentStatistics to serialize
+ *  \param[out] out The output buffer, at least size(stats) bytes
+ *  \return char* The end of the snapshot written
+ */
+template <class T, class U, class S>
+char *write(const RecurrentStatistics<T, U, S> &stats, char *out) noexcept {
+  out = details::writeHeader(out, Kind::Statistics, statistics_payload_size);
+  details::store(out, std::uint64_t(stats.getNumberOfMeasurements()));
+  details::store(out + 8, static_cast<double>(stats.getMean()));
+  details::store(out + 16, static_cast<double>(stats.getSumSquare()));
+  return out + statistics_payload_size;
+}
+
+/**
+ *  \brief View over a Kind::Statistics snapshot
+ */
+class StatisticsView : public View {
+public:
+  using View::View;
+
+  /**
+   *  \return bool True when this is a valid Kind::Statistics snapshot: the
+   *          mean is finite and the sum of squares finite and positive
+   */
+  bool isValid() const noexcept {
+    return View::isValid(Kind::Statistics, statistics_payload_size) &&
+           std::isfinite(getMean()) && std::isfinite(getSumSquare()) &&
+           getSumSquare() >= 0;
+  }
+
+  //! \return std::uint64_t N the number of measurment
+  std::uint64_t getNumberOfMeasurements() const noexcept {
+    return details::load<std::uint64_t>(payload());
+  }
+
+  //! \return double The mean
+  double getMean() const noexcept { return details::loadDouble(payload() + 8); }
+
+  //! \return double The sum of squares
+  double getSumSquare() const noexcept {
+    return details::loadDouble(payload() + 16);
+  }
+
+  /**
+   *  \brief Deserialize the snapshot
+   *  \return std::optional<RecurrentStatistics> The statistics contained,
+   *          empty when the snapshot isn't valid
+   */
+  template <class T, class U = T, class S = U>
+  std::optional<RecurrentStatistics<T, U, S>> toStatistics() const {
+    if (not isValid())
+      return std::nullopt;
+
+    return RecurrentStatistics<T, U, S>(
+        static_cast<std::size_t>(getNumberOfMeasurements()),
+        static_cast<U>(getMean()), static_cast<S>(getSumSquare()));
+  }
+};
+
+/**
+ *  \brief Get the size needed to serialize a LogHistogram
+ *  \return std::size_t The size, in bytes
+ */
+inline std::size_t size(const LogHistogram &histogram) noexcept {
+  return header_size + 40 + 8 * histogram.getNumberOfBuckets();
+}
+
+/**
+ *  \brief Serialize a LogHistogram
+ *  \param[in] histogram The LogHistogram to serialize
+ *  \param[out] out The output buffer, at least size(histogram) bytes
+ *  \return char* The end of the snapshot written
+ */
+inline char *write(const LogHistogram &histogram, char *out) noexcept {
+  const auto &counts = Access::counts(histogram);
+  out = details::writeHeader(out, Kind::LogHistogram, 40 + 8 * counts.size());
+  details::store(out, std::uint32_t(histogram.getPrecision()));
+  details::store(out + 4, std::uint32_t(counts.size()));
+  details::store(out + 8, std::uint64_t(histogram.getMaxValue()));
+  details::store(out + 16, std::uint64_t(histogram.getNumberOfMeasurements()));
+  details::store(out + 24, std::uint64_t(histogram.getMin()));
+  details::store(out + 32, std::uint64_t(histogram.getMax()));
+  out += 40;
+  for (const auto &count : counts) {
+    details::store(out, std::uint64_t(count));
+    out += 8;
+  }
+  return out;
+}
+
+/**
+ *  \brief View over a Kind::LogHistogram snapshot
+ */
+class LogHistogramView : public View {
+public:
+  using View::View;
+
+  /**
+   *  \return bool True when this is a valid Kind::LogHistogram snapshot: the
+   *          precision is in [1, 32] and the number of buckets matches the
+   *          max value (the histogram can be built without allocating more
+   *          than the size of the snapshot)
+   */
+  bool isValid() const noexcept {
+    return View::isValid(Kind::LogHistogram, 40) &&
+           getPayloadSize() == 40 + 8 * std::uint64_t(getNumberOfBuckets()) &&
+           getPrecision() >= 1 && getPrecision() <= 32 &&
+           getNumberOfBuckets() ==
+               LogHistogram::indexOf(getMaxValue(), getPrecision()) + 1;
+  }
+
+  //! \return unsigned The precision of the histogram
+  unsigned getPrecision() const noexcept {
+    return details::load<std::uint32_t>(payload());
+  }
+
+  //! \return std::size_t The number of buckets
+  std::size_t getNumberOfBuckets() const noexcept {
+    return details::load<std::uint32_t>(payload() + 4);
+  }
+
+  //! \return LogHistogram::value_type The max value of the histogram
+  LogHistogram::value_type getMaxValue() const noexcept {
+    return details::load<std::uint64_t>(payload() + 8);
+  }
+
+  //! \return LogHistogram::count_type N the number of measurment
+  LogHistogram::count_type getNumberOfMeasurements() const noexcept {
+    return details::load<std::uint64_t>(payload() + 16);
+  }
+
+  //! \return LogHistogram::value_type The smallest value recorded
+  LogHistogram::value_type getMin() const noexcept {
+    return details::load<std::uint64_t>(payload() + 24);
+  }
+
+  //! \return LogHistogram::value_type The biggest value recorded
+  LogHistogram::value_type getMax() const noexcept {
+    return details::load<std::uint64_t>(payload() + 32);
+  }
+
+  /**
+   *  \param[in] index The bucket index (< getNumberOfBuckets())
+   *  \return LogHistogram::count_type The count of the bucket
+   */
+  LogHistogram::count_type getCount(const std::size_t index) const noexcept {
+    return details::load<std::uint64_t>(payload() + 40 + 8 * index);
+  }
+
+  /**
+   *  \brief Merge the snapshot into an histogram, without deserializing it
+   *  \param[in,out] histogram The histogram to merge into
+   *  \return bool False when the snapshot isn't valid or the histogram
+   *          configuration (precision, max value) doesn't match the snapshot
+   *          (nothing is merged)
+   */
+  bool mergeInto(LogHistogram &histogram) const {
+    if (not isValid() || histogram.getPrecision() != getPrecision() ||
+        histogram.getMaxValue() != getMaxValue() ||
+        histogram.getNumberOfBuckets() != getNumberOfBuckets())
+      return false;
+
+    Access::mergeCounts(histogram, payload() + 40, getNumberOfMeasurements(),
+                        getMin(), getMax());
+    return true;
+  }
+
+  /**
+   *  \brief Deserialize the snapshot
+   *  \return std::optional<LogHistogram> The histogram contained, empty when
+   *          the snapshot isn't valid
+   */
+  std::optional<LogHistogram> toHistogram() const {
+    if (not isValid())
+      return std::nullopt;
+
+    LogHistogram histogram(getMaxValue(), getPrecision());
+    if (not mergeInto(histogram))
+      return std::nullopt;
+    return histogram;
+  }
+};
+
+/**
+ *  \brief Get the size needed to serialize a TDigest
+ *  \return std::size_t The size, in bytes
+ */
+template <class T> std::size_t size(const TDigest<T> &digest) {
+  return header_size + 32 + 16 * digest.getNumberOfCentroids();
+}
+
+/**
+ *  \brief Serialize a TDigest (centroids as binary64)
+ *  \param[in] digest The TDigest to serialize
+ *  \param[out] out The output buffer, at least size(digest) bytes
+ *  \return char* The end of the snapshot written
+ */
+template <class T> char *write(const TDigest<T> &digest, char *out) {
+  const auto centroids = digest.getNumberOfCentroids();
+  out = details::writeHeader(out, Kind::TDigest, 32 + 16 * centroids);
+  details::store(out, std::uint32_t(digest.getCompression()));
+  details::store(out + 4, std::uint32_t(centroids));
+  details::store(out + 8, std::uint64_t(digest.getNumberOfMeasurements()));
+  details::store(out + 16, static_cast<double>(digest.getMin()));
+  details::store(out + 24, static_cast<double>(digest.getMax()));
+  out += 32;
+  Access::forEachCentroid(digest, [&out](const T &mean, const T &weight) {
+    details::store(out, static_cast<double>(mean));
+    details::store(out + 8, static_cast<double>(weight));
+    out += 16;
+  });
+  return out;
+}
+
+/**
+ *  \brief View over a Kind::TDigest snapshot
+ */
+class TDigestView : public View {
+public:
+  using View::View;
+
+  /**
+   *  \return bool True when this is a valid Kind::TDigest snapshot: the
+   *          compression is in [1, max_tdigest_compression], the number of
+   *          centroids fits the compression, the centroids are finite with a
+   *          strictly positive weight and their weights sum up to N
+   */
+  bool isValid() const noexcept {
+    if (not View::isValid(Kind::TDigest, 32) ||
+        getPayloadSize() != 32 + 16 * std::uint64_t(getNumberOfCentroids()))
+      return false;
+
+    // Same lower bound than the TDigest constructor
+    const auto compression =
+        std::max<std::size_t>(getCompression(), std::size_t{10});
+    if (getCompression() == 0 || getCompression() > max_tdigest_compression ||
+        getNumberOfCentroids() > 2 * compression)
+      return false;
+
+    double weights = 0;
+    for (std::size_t i = 0; i < getNumberOfCentroids(); ++i) {
+      const auto centroid = getCentroid(i);
+      if (not std::isfinite(centroid.first) ||
+          not std::isfinite(centroid.second) || not(centroid.second > 0))
+        return false;
+      weights += centroid.second;
+    }
+
+    // Centroid weights are sums of unit weights: the sum is exact
+    return weights == static_cast<double>(getNumberOfMeasurements()) &&
+           (getNumberOfMeasurements() == 0 ||
+            (std::isfinite(getMin()) && std::isfinite(getMax()) &&
+             getMin() <= getMax()));
+  }
+
+  //! \return std::size_t The compression of the digest
+  std::size_t getCompression() const noexcept {
+    return details::load<std::uint32_t>(payload());
+  }
+
+  //! \return std::size_t The number of centroids
+  std::size_t getNumberOfCentroids() const noexcept {
+    return details::load<std::uint32_t>(payload() + 4);
+  }
+
+  //! \return std::uint64_t N the number of measurment
+  std::uint64_t getNumberOfMeasurements() const noexcept {
+    return details::load<std::uint64_t>(payload() + 8);
+  }
+
+  //! \return double The smallest measurement
+  double getMin() const noexcept { return details::loadDouble(payload() + 16); }
+
+  //! \return double The biggest measurement
+  double getMax() const noexcept { return details::loadDouble(payload() + 24); }
+
+  /**
+   *  \param[in] index The centroid index (< getNumberOfCentroids())
+   *  \return std::pair<double, double> The (mean, weight) of the centroid
+   */
+  std::pair<double, double> getCentroid(const std::size_t index) const {
+    const char *centroid = payload() + 32 + 16 * index;
+    return {details::loadDouble(centroid), details::loadDouble(centroid + 8)};
+  }
+
+  /**
+   *  \brief Merge the snapshot into a digest, without deserializing it
+   *  \param[in,out] digest The digest to merge into
+   *  \return bool False when the snapshot isn't valid (nothing is merged)
+   */
+  template <class T> bool mergeInto(TDigest<T> &digest) const {
+    if (not isValid())
+      return false;
+
+    mergeValidInto(digest);
+    return true;
+  }
+
+  /**
+   *  \brief Deserialize the snapshot
+   *  \return std::optional<TDigest> The digest contained, empty when the
+   *          snapshot isn't valid
+   */
+  template <class T = double> std::optional<TDigest<T>> toTDigest() const {
+    if (not isValid())
+      return std::nullopt;
+
+    TDigest<T> digest(getCompression());
+    mergeValidInto(digest);
+    return digest;
+  }
+
+private:
+  template <class T> void mergeValidInto(TDigest<T> &digest) const {
+    for (std::size_t i = 0; i < getNumberOfCentroids(); ++i) {
+      const auto centroid = getCentroid(i);
+      Access::mergeCentroid(digest, static_cast<T>(centroid.first),
+                            static_cast<T>(centroid.second));
+    }
+    Access::mergeSummary(digest,
+                         static_cast<std::size_t>(getNumberOfMeasurements()),
+                         static_cast<T>(getMin()), static_cast<T>(getMax()));
+  }
+};
+
+} // namespace snapshot
+} // namespace stats
+} // namespace arthoolbox
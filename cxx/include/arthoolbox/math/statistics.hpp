@@ -4,9 +4,19 @@
  *   \brief Contains usefulll tools to perform staticstics computations
  */
 
-#include <cassert> // assert
-#include <cstdlib> // std::size_t
-#include <sstream> // stringstream
+#include <algorithm>   // min, copy
+#include <cassert>     // assert
+#include <charconv>    // to_chars
+#include <cstdint>     // int64_t, uint64_t
+#include <cstdlib>     // std::size_t
+#include <future>      // async
+#include <iterator>    // iterator_traits, back_inserter
+#include <sstream>     // stringstream
+#include <string>
+#include <type_traits> // is_integral, conditional
+#include <vector>
+
+#include "arthoolbox/execution.hpp"
 
 namespace arthoolbox {
 namespace stats {
@@ -54,10 +64,10 @@ constexpr U update_recurring_mean(const T &new_sample, const U &old_mean,
  *  \param[in] new_mean The new mean Mn
  *  \param[in] old_mean The previously computed mean Mn-1
  *  \param[in] data_number The number of data n used to compute Mn/Vn
- *  \return T The new variance computed
+ *  \return V The new variance computed
  */
 template <class T, class U = T, class V = T>
-constexpr T update_recurring_variance(const T &new_sample,
+constexpr V update_recurring_variance(const T &new_sample,
                                       const V &old_variance, const U &new_mean,
                                       const U &old_mean,
                                       const std::size_t data_number) noexcept {
@@ -91,15 +101,233 @@ constexpr T update_recurring_variance(const T &new_sample,
  *  \param[in] old_sum_square The previously computed variance Vn-1
  *  \param[in] new_mean The new mean Mn
  *  \param[in] old_mean The previously computed mean Mn-1
- *  \return T The new variance computed
+ *  \return S The new sum of squares computed
  */
 template <class T, class U = T, class S = T>
-constexpr T
+constexpr S
 update_recurring_sum_square(const T &new_sample, const S &old_sum_square,
                             const U &new_mean, const U &old_mean) noexcept {
   return (old_sum_square + (new_sample - new_mean) * (new_sample - old_mean));
 }
 
+/**
+ *  \brief Merge two statistical means computed over disjoint sets of data
+ *
+ *  From the means M_a and M_b, computed respectively using n_a and n_b
+ *  measurements, we compute the mean M_ab of the union of both sets with:
+ *  M_ab = M_a + (M_b - M_a) * n_b / (n_a + n_b)
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Parallel algorithm, Chan et al.)
+ *
+ *  \tparam U The mean type
+ *
+ *  \param[in] lhs_mean The mean M_a
+ *  \param[in] lhs_data_number The number of data n_a used to compute M_a
+ *  \param[in] rhs_mean The mean M_b
+ *  \param[in] rhs_data_number The number of data n_b used to compute M_b
+ *  \return U The merged mean M_ab (n_a + n_b must be != 0)
+ */
+template <class U>
+constexpr U merge_recurring_mean(const U &lhs_mean,
+                                 const std::size_t lhs_data_number,
+                                 const U &rhs_mean,
+                                 const std::size_t rhs_data_number) noexcept {
+  return (lhs_mean + (rhs_mean - lhs_mean) * rhs_data_number /
+                         (lhs_data_number + rhs_data_number));
+}
+
+/**
+ *  \brief Merge two statistical co-moments computed over disjoint sets of data
+ *
+ *  From the co-moments C_a and C_b of (x, y) and the means (Mx_a, My_a) and
+ *  (Mx_b, My_b), computed respectively using n_a and n_b measurements, we
+ *  compute the co-moment C_ab of the union of both sets with:
+ *  C_ab = C_a + C_b + (Mx_b - Mx_a) * (My_b - My_a) * n_a * n_b / (n_a + n_b)
+ *
+ *  The sum of squares is the co-moment of x with itself.
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Covariance, Online)
+ *
+ *  \tparam U The mean type
+ *  \tparam S The co-moment type
+ *
+ *  \param[in] lhs_co_moment The co-moment C_a
+ *  \param[in] lhs_mean_x, lhs_mean_y The means Mx_a and My_a
+ *  \param[in] lhs_data_number The number of data n_a used to compute C_a
+ *  \param[in] rhs_co_moment The co-moment C_b
+ *  \param[in] rhs_mean_x, rhs_mean_y The means Mx_b and My_b
+ *  \param[in] rhs_data_number The number of data n_b used to compute C_b
+ *  \return S The merged co-moment C_ab (n_a + n_b must be != 0)
+ */
+template <class U, class S = U>
+constexpr S merge_recurring_co_moment(
+    const S &lhs_co_moment, const U &lhs_mean_x, const U &lhs_mean_y,
+    const std::size_t lhs_data_number, const S &rhs_co_moment,
+    const U &rhs_mean_x, const U &rhs_mean_y,
+    const std::size_t rhs_data_number) noexcept {
+  return (lhs_co_moment + rhs_co_moment +
+          (rhs_mean_x - lhs_mean_x) * (rhs_mean_y - lhs_mean_y) *
+              lhs_data_number * rhs_data_number /
+              (lhs_data_number + rhs_data_number));
+}
+
+/**
+ *  \brief Merge two statistical sums of squares computed over disjoint sets of
+ *  data
+ *
+ *  From the sums of squares SUM_a and SUM_b and the means M_a and M_b,
+ *  computed respectively using n_a and n_b measurements, we compute the sum of
+ *  squares SUM_ab of the union of both sets with:
+ *  SUM_ab = SUM_a + SUM_b + (M_b - M_a)^2 * n_a * n_b / (n_a + n_b)
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *  (Parallel algorithm, Chan et al.)
+ *
+ *  \tparam U The mean type
+ *  \tparam S The sum squares type
+ *
+ *  \param[in] lhs_sum_square The sum of squares SUM_a
+ *  \param[in] lhs_mean The mean M_a
+ *  \param[in] lhs_data_number The number of data n_a used to compute SUM_a
+ *  \param[in] rhs_sum_square The sum of squares SUM_b
+ *  \param[in] rhs_mean The mean M_b
+ *  \param[in] rhs_data_number The number of data n_b used to compute SUM_b
+ *  \return S The merged sum of squares SUM_ab (n_a + n_b must be != 0)
+ */
+template <class U, class S = U>
+constexpr S merge_recurring_sum_square(
+    const S &lhs_sum_square, const U &lhs_mean,
+    const std::size_t lhs_data_number, const S &rhs_sum_square,
+    const U &rhs_mean, const std::size_t rhs_data_number) noexcept {
+  return merge_recurring_co_moment(lhs_sum_square, lhs_mean, lhs_mean,
+                                   lhs_data_number, rhs_sum_square, rhs_mean,
+                                   rhs_mean, rhs_data_number);
+}
+
+/**
+ *  \brief Floating point accumulator using compensated (Neumaier) summation
+ *
+ *  Each addition keeps track of the low order bits lost by the rounding, in a
+ *  separate compensation term. The accumulated value is sum + compensation.
+ *
+ *  It can be used as mean/sum of squares type of the recurrent statistics to
+ *  accumulate float samples with an accuracy close to double, e.g.:
+ *  RecurrentStatistics<float, CompensatedSum<float>>
+ *
+ *  Only the additions into the accumulator are compensated: any other
+ *  operation implicitly converts it to V.
+ *
+ *  See: https://en.wikipedia.org/wiki/Kahan_summation_algorithm
+ *
+ *  \tparam V The floating point type
+ */
+template <class V> class CompensatedSum {
+public:
+  using value_type = V;
+
+  //! Constructor (implicit, an accumulator can be used as a V)
+  constexpr CompensatedSum(const V &value = V{})
+      : sum_(value), compensation_(){};
+
+  //! Get the compensated value (sum + compensation)
+  constexpr operator V() const noexcept { return sum_ + compensation_; }
+
+  /**
+   *  \brief Add a term to the accumulator (Neumaier summation)
+   *  \param[in] term The value added
+   *  \return CompensatedSum& *this
+   */
+  constexpr CompensatedSum &operator+=(const V &term) noexcept {
+    const V total = sum_ + term;
+    if ((sum_ < 0 ? -sum_ : sum_) >= (term < 0 ? -term : term))
+      compensation_ += (sum_ - total) + term;
+    else
+      compensation_ += (term - total) + sum_;
+    sum_ = total;
+    return *this;
+  }
+
+  constexpr CompensatedSum &operator+=(const CompensatedSum &other) noexcept {
+    *this += other.sum_;
+    *this += other.compensation_;
+    return *this;
+  }
+
+  friend constexpr CompensatedSum operator+(CompensatedSum lhs,
+                                            const V &rhs) noexcept {
+    return lhs += rhs;
+  }
+
+  friend constexpr CompensatedSum
+  operator+(CompensatedSum lhs, const CompensatedSum &rhs) noexcept {
+    return lhs += rhs;
+  }
+
+private:
+  V sum_;          /*!< Hold the rounded sum */
+  V compensation_; /*!< Hold the rounding errors of the sum */
+};
+
+namespace details {
+
+/// Number of independent partial sums used by the batch kernels
+constexpr std::size_t batch_lanes = 8;
+
+/// Number of samples reduced at once before being merged into the stats
+constexpr std::size_t batch_block_size = 256;
+
+/**
+ *  \brief Compute the mean and sum of squares of a small block of samples
+ *
+ *  The block is reduced in two passes (sum, then squared deviations from the
+ *  block mean) using batch_lanes independent accumulators. This removes the
+ *  dependency chain of the recurrent formulas and lets the compiler vectorize
+ *  the loops.
+ *
+ *  \param[in] first Random access iterator to the first sample
+ *  \param[in] n The number of samples in the block (must be != 0)
+ *  \param[out] mean The block mean
+ *  \param[out] sum_square The block sum of squares
+ */
+template <class U, class S, class RandomIt>
+void reduce_block(RandomIt first, const std::size_t n, U &mean,
+                  S &sum_square) {
+  U sums[batch_lanes] = {};
+  std::size_t i = 0;
+  for (; i + batch_lanes <= n; i += batch_lanes)
+    for (std::size_t lane = 0; lane < batch_lanes; ++lane)
+      sums[lane] += first[i + lane];
+
+  U sum = {};
+  for (std::size_t lane = 0; lane < batch_lanes; ++lane)
+    sum += sums[lane];
+  for (; i < n; ++i)
+    sum += first[i];
+
+  mean = sum / n;
+
+  S squares[batch_lanes] = {};
+  i = 0;
+  for (; i + batch_lanes <= n; i += batch_lanes) {
+    for (std::size_t lane = 0; lane < batch_lanes; ++lane) {
+      const U delta = first[i + lane] - mean;
+      squares[lane] += delta * delta;
+    }
+  }
+
+  sum_square = S{};
+  for (std::size_t lane = 0; lane < batch_lanes; ++lane)
+    sum_square += squares[lane];
+  for (; i < n; ++i) {
+    const U delta = first[i] - mean;
+    sum_square += delta * delta;
+  }
+}
+
+} // namespace details
+
 /**
  *  \brief Enables online recurrent statistics computation of a given sample
  *
@@ -119,6 +347,12 @@ public:
       : number_of_measurements_(0), mean_(init_mean),
         sum_square_(init_sum_square){};
 
+  //! Constructor from already computed statistics (N, mean and sum square)
+  RecurrentStatistics(const std::size_t number_of_measurements, const U &mean,
+                      const S &sum_square)
+      : number_of_measurements_(number_of_measurements), mean_(mean),
+        sum_square_(sum_square){};
+
   /**
    *  \brief Reset the statistics (N set to 0)
    *  \param[in] mean The new default value used as mean
@@ -144,6 +378,12 @@ public:
    */
   U getMean() const noexcept { return mean_; }
 
+  /**
+   *  \brief Get the currently computed sum of squares
+   *  \return S The sum of squares computed
+   */
+  S getSumSquare() const noexcept { return sum_square_; }
+
   /**
    *  \brief Get the currently computed variance
       \notes Number of measurement must be != 0
@@ -178,44 +418,527 @@ public:
     mean_ = new_mean;
   };
 
+  /**
+   *  \brief Update the computed stats with a range of new measurements
+   *
+   *  With random access iterators, the samples are reduced by blocks (see
+   *  details::reduce_block) and each block is merged into the current stats
+   *  using merge_recurring_mean/merge_recurring_sum_square. Other iterators
+   *  fall back to calling updateWith() on each sample.
+   *
+   *  \param[in] first, last The range of measurements
+   */
+  template <class InputIt> void updateWith(InputIt first, InputIt last) {
+    updateWith(first, last,
+               typename std::iterator_traits<InputIt>::iterator_category{});
+  }
+
+  /**
+   *  \brief Merge the stats computed over an other set of measurements
+   *
+   *  After the merge, *this holds the statistics of the union of both sets
+   *  of measurements (see merge_recurring_mean/merge_recurring_sum_square).
+   *
+   *  \param[in] other The statistics to merge into *this
+   *  \return RecurrentStatistics& *this
+   */
+  RecurrentStatistics &merge(const RecurrentStatistics &other) {
+    mergeWith(other.number_of_measurements_, other.mean_, other.sum_square_);
+    return *this;
+  }
+
 private:
+  template <class InputIt>
+  void updateWith(InputIt first, InputIt last, std::input_iterator_tag) {
+    for (; first != last; ++first)
+      updateWith(*first);
+  }
+
+  template <class RandomIt>
+  void updateWith(RandomIt first, RandomIt last,
+                  std::random_access_iterator_tag) {
+    auto remaining = static_cast<std::size_t>(std::distance(first, last));
+    while (remaining != 0) {
+      const auto n = remaining < details::batch_block_size
+                         ? remaining
+                         : details::batch_block_size;
+
+      U block_mean;
+      S block_sum_square;
+      details::reduce_block(first, n, block_mean, block_sum_square);
+      mergeWith(n, block_mean, block_sum_square);
+
+      first += n;
+      remaining -= n;
+    }
+  }
+
+  void mergeWith(const std::size_t n, const U &mean, const S &sum_square) {
+    if (n == 0)
+      return;
+
+    sum_square_ = merge_recurring_sum_square(
+        sum_square_, mean_, number_of_measurements_, sum_square, mean, n);
+
+    if (number_of_measurements_ == 0)
+      mean_ = mean;
+    else
+      mean_ = merge_recurring_mean(mean_, number_of_measurements_, mean, n);
+
+    number_of_measurements_ += n;
+  }
+
+
   std::size_t
       number_of_measurements_; /*!< Hold the current number of measurment N */
   U mean_;                     /*!< Hold the currently computed mean */
   S sum_square_;               /*!< Hold the sum square */
 };
 
+/**
+ *  \brief Compute the statistics of a range of samples on the calling thread
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam U The mean type
+ *  \tparam S The variance type
+ *
+ *  \param[in] first, last The range of samples
+ *  \return RecurrentStatistics The statistics of [first, last[
+ */
+template <class InputIt,
+          class T = typename std::iterator_traits<InputIt>::value_type,
+          class U = T, class S = U>
+RecurrentStatistics<T, U, S> compute_statistics(execution::sequenced_policy,
+                                                InputIt first, InputIt last) {
+  RecurrentStatistics<T, U, S> stats;
+  stats.updateWith(first, last);
+  return stats;
+}
+
+/**
+ *  \brief Compute the statistics of a range of samples using multiple threads
+ *
+ *  The range is split into contiguous chunks (at most one per thread), each
+ *  chunk being reduced by its own RecurrentStatistics. The partial results
+ *  are then merged together, in order, on the calling thread.
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam U The mean type
+ *  \tparam S The variance type
+ *
+ *  \param[in] policy The parallel policy (gives the number of threads)
+ *  \param[in] first, last The range of samples
+ *  \return RecurrentStatistics The statistics of [first, last[
+ */
+template <class RandomIt,
+          class T = typename std::iterator_traits<RandomIt>::value_type,
+          class U = T, class S = U>
+RecurrentStatistics<T, U, S>
+compute_statistics(const execution::parallel_policy &policy, RandomIt first,
+                   RandomIt last) {
+  // Below this amount of samples per thread, spawning is not worth it
+  constexpr std::size_t min_chunk_size = 1 << 14;
+
+  const auto n = static_cast<std::size_t>(std::distance(first, last));
+  const auto chunks = std::max<std::size_t>(
+      1, std::min(policy.concurrency(), n / min_chunk_size));
+  const auto chunk_size = n / chunks;
+
+  std::vector<std::future<RecurrentStatistics<T, U, S>>> partials;
+  partials.reserve(chunks - 1);
+
+  for (std::size_t i = 1; i < chunks; ++i) {
+    const auto chunk_first = first + i * chunk_size;
+    const auto chunk_last = (i + 1 == chunks) ? last : chunk_first + chunk_size;
+    partials.push_back(
+        std::async(std::launch::async, [chunk_first, chunk_last] {
+          return compute_statistics<RandomIt, T, U, S>(
+              execution::seq, chunk_first, chunk_last);
+        }));
+  }
+
+  auto stats = compute_statistics<RandomIt, T, U, S>(execution::seq, first,
+                                                     first + chunk_size);
+  for (auto &partial : partials)
+    stats.merge(partial.get());
+
+  return stats;
+}
+
+namespace details {
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/// Integer types used to accumulate the (shifted) sums of integer samples
+template <class T> struct integer_sums {
+  static_assert(std::is_integral<T>::value, "T must be an integral type");
+
+#ifdef __SIZEOF_INT128__
+  using sum_type = typename std::conditional<(sizeof(T) <= 2), std::int64_t,
+                                             int128_t>::type;
+  using sum_square_type = typename std::conditional<(sizeof(T) <= 2),
+                                                    std::uint64_t,
+                                                    uint128_t>::type;
+#else
+  using sum_type = std::int64_t;
+  using sum_square_type = std::uint64_t;
+#endif
+};
+
+} // namespace details
+
+/**
+ *  \brief Integer exact statistics of integer samples
+ *
+ *  Recording a sample only performs integer additions/multiplication: the
+ *  sum and the sum of squares of the samples, shifted by the first one (K),
+ *  are accumulated into 64 or 128 bits integers (when supported). The mean
+ *  and the variance are only computed (in R) when queried:
+ *  Mean = K + Sum(X - K) / N
+ *  Var  = (Sum((X - K)^2) - Sum(X - K)^2 / N) / N
+ *
+ *  Shifting the samples keeps the sums small for samples close to each other
+ *  (e.g. nanoseconds timestamps) and limits the cancellation when computing
+ *  the variance.
+ *
+ *  See: https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance
+ *
+ *  \notes This class is not thread safe !
+ *  \notes The sums are exact as long as they don't overflow: the squared
+ *  distance to the first sample, times N, must fit into sum_square_type
+ *
+ *  \tparam T The integral measurement sample type
+ *  \tparam R The floating point type used to compute the mean/variance
+ */
+template <class T, class R = double> class IntegerStatistics {
+public:
+  using sum_type = typename details::integer_sums<T>::sum_type;
+  using sum_square_type = typename details::integer_sums<T>::sum_square_type;
+
+  //! Default constructor
+  constexpr IntegerStatistics() noexcept
+      : number_of_measurements_(0), offset_(), sum_(0), sum_square_(0){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  constexpr void reset() noexcept { *this = IntegerStatistics(); }
+
+  /**
+   *  \brief Get the number of measurement N
+   *  \return std::size_t N the number of measurment
+   */
+  constexpr std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the offset K (the first sample) the sums are shifted by
+   *  \return T The offset
+   */
+  constexpr T getOffset() const noexcept { return offset_; }
+
+  /**
+   *  \brief Get the exact sum of the shifted samples: Sum(X - K)
+   *  \return sum_type The shifted sum
+   */
+  constexpr sum_type getShiftedSum() const noexcept { return sum_; }
+
+  /**
+   *  \brief Get the exact sum of squares of the shifted samples:
+   *  Sum((X - K)^2)
+   *  \return sum_square_type The shifted sum of squares
+   */
+  constexpr sum_square_type getShiftedSumSquare() const noexcept {
+    return sum_square_;
+  }
+
+  /**
+   *  \brief Compute the mean
+   *  \return R The mean (0 when N = 0)
+   */
+  constexpr R getMean() const noexcept {
+    if (number_of_measurements_ == 0)
+      return R{};
+
+    return static_cast<R>(offset_) +
+           static_cast<R>(sum_) / static_cast<R>(number_of_measurements_);
+  }
+
+  /**
+   *  \brief Compute the variance
+      \notes Number of measurement must be != 0
+   *  \return R the variance
+   */
+  constexpr R getVariance() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return getSumSquare() / static_cast<R>(number_of_measurements_);
+  }
+
+  /**
+   *  \brief Compute the sampled variance
+      \notes Number of measurement must be > 1
+   *  \return R the sampled variance
+   */
+  constexpr R getSampledVariance() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the sample variance");
+    return getSumSquare() / static_cast<R>(number_of_measurements_ - 1);
+  }
+
+  /**
+   *  \brief Update the sums with the new measurement
+   *  \param[in] new_data The new measurement
+   */
+  constexpr void updateWith(const T &new_data) noexcept {
+    if (number_of_measurements_ == 0)
+      offset_ = new_data;
+
+    const auto shifted =
+        static_cast<sum_type>(new_data) - static_cast<sum_type>(offset_);
+    ++number_of_measurements_;
+    sum_ += shifted;
+    sum_square_ += static_cast<sum_square_type>(shifted) *
+                   static_cast<sum_square_type>(shifted);
+  }
+
+  /**
+   *  \brief Merge the measurements of an other IntegerStatistics
+   *  \param[in] other The statistics merged into this one
+   */
+  constexpr void merge(const IntegerStatistics &other) noexcept {
+    if (other.number_of_measurements_ == 0)
+      return;
+
+    if (number_of_measurements_ == 0) {
+      *this = other;
+      return;
+    }
+
+    // Shift the other sums by D = K_other - K:
+    // Sum(X - K) = Sum(X - K_other) + N_other * D
+    // Sum((X - K)^2) = Sum((X - K_other)^2) + 2D * Sum(X - K_other)
+    //                  + N_other * D^2
+    const auto delta = static_cast<sum_type>(other.offset_) -
+                       static_cast<sum_type>(offset_);
+    const auto other_n = static_cast<sum_type>(other.number_of_measurements_);
+
+    number_of_measurements_ += other.number_of_measurements_;
+    sum_ += other.sum_ + other_n * delta;
+    sum_square_ +=
+        other.sum_square_ +
+        static_cast<sum_square_type>(2 * delta) *
+            static_cast<sum_square_type>(other.sum_) +
+        static_cast<sum_square_type>(other_n) *
+            static_cast<sum_square_type>(delta) *
+            static_cast<sum_square_type>(delta);
+  }
+
+private:
+  /// Sum of squares of the samples minus their mean: S2 - S1^2 / N
+  constexpr R getSumSquare() const noexcept {
+    const auto sum = static_cast<R>(sum_);
+    return static_cast<R>(sum_square_) -
+           sum * sum / static_cast<R>(number_of_measurements_);
+  }
+
+  std::size_t number_of_measurements_; /*!< Hold the number of measurement */
+  T offset_;                           /*!< Hold the shift K (first sample) */
+  sum_type sum_;                       /*!< Hold Sum(X - K) */
+  sum_square_type sum_square_;         /*!< Hold Sum((X - K)^2) */
+};
+
+/// The layouts available to format a RecurrentStatistics
+enum class FormatStyle {
+  Multiline, /*!< "Stats [N = n]\nMean: m\nVar : v\nSVar: s" */
+  Compact,   /*!< "N=n mean=m var=v svar=s", '-' when not available */
+};
+
+/// Result of format_to_n()
+struct FormatToNResult {
+  char *out;        /*!< Hold the end of the characters written */
+  std::size_t size; /*!< Hold the size of the untruncated output */
+};
+
+namespace details {
+
+template <class OutputIt>
+OutputIt format_text_to(OutputIt out, const char *text) {
+  for (; *text != '\0'; ++text, ++out)
+    *out = *text;
+  return out;
+}
+
+/// True when V can be written by format_value_to (using std::to_chars)
+template <class V>
+struct is_to_chars_formattable
+    : std::integral_constant<bool, std::is_arithmetic<V>::value &&
+                                       not std::is_same<V, bool>::value> {};
+
+template <class V>
+struct is_to_chars_formattable<CompensatedSum<V>>
+    : is_to_chars_formattable<V> {};
+
+template <class OutputIt, class V>
+OutputIt format_value_to(OutputIt out, const V &value) {
+  char buffer[64];
+  std::to_chars_result result;
+  if constexpr (std::is_floating_point<V>::value)
+    // Same output as the default std::ostream formatting (%g, 6 digits)
+    result = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                           std::chars_format::general, 6);
+  else
+    result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  return std::copy(buffer, result.ptr, out);
+}
+
+template <class OutputIt, class V>
+OutputIt format_value_to(OutputIt out, const CompensatedSum<V> &value) {
+  return format_value_to(out, static_cast<V>(value));
+}
+
+/// Output iterator writing into [out, end) and counting every character
+struct BoundedCharWriter {
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  char *out;
+  char *end;
+  std::size_t size;
+
+  BoundedCharWriter &operator=(const char c) noexcept {
+    if (out != end)
+      *out++ = c;
+    ++size;
+    return *this;
+  }
+  BoundedCharWriter &operator*() noexcept { return *this; }
+  BoundedCharWriter &operator++() noexcept { return *this; }
+  BoundedCharWriter &operator++(int) noexcept { return *this; }
+};
+
+} // namespace details
+
+/**
+ *  \brief Format a RecurrentStatistics, without any allocation
+ *
+ *  Values are written using std::to_chars (locale independent), floating
+ *  points with the same 6 significant digits as the std::ostream default.
+ *  The mean and variance types must be arithmetic types (or CompensatedSum).
+ *
+ *  \tparam OutputIt A char output iterator
+ *
+ *  \param[in] out The output iterator written
+ *  \param[in] stats The RecurrentStatistics object to format
+ *  \param[in] style The layout used
+ *  \return OutputIt The iterator past the last character written
+ */
+template <class OutputIt, class T, class U, class S>
+OutputIt format_to(OutputIt out, const RecurrentStatistics<T, U, S> &stats,
+                   const FormatStyle style = FormatStyle::Multiline) {
+  static_assert(details::is_to_chars_formattable<U>::value &&
+                    details::is_to_chars_formattable<S>::value,
+                "The mean and variance types must be written by to_chars");
+
+  const auto n = stats.getNumberOfMeasurements();
+  const bool compact = (style == FormatStyle::Compact);
+  const char *not_available = compact ? "-" : " -> Not enough samples yet";
+
+  out = details::format_text_to(out, compact ? "N=" : "Stats [N = ");
+  out = details::format_value_to(out, n);
+  out = details::format_text_to(out, compact ? " mean=" : "]\nMean: ");
+  out = details::format_value_to(out, stats.getMean());
+
+  out = details::format_text_to(out, compact ? " var=" : "\nVar : ");
+  if (n > 0)
+    out = details::format_value_to(out, stats.getVariance());
+  else
+    out = details::format_text_to(out, not_available);
+
+  out = details::format_text_to(out, compact ? " svar=" : "\nSVar: ");
+  if (n > 1)
+    out = details::format_value_to(out, stats.getSampledVariance());
+  else
+    out = details::format_text_to(out, not_available);
+
+  return out;
+}
+
+/**
+ *  \brief Format a RecurrentStatistics into a char buffer, truncating the
+ *  output to at most size characters (no null terminator is written)
+ *
+ *  \param[in] out The buffer written
+ *  \param[in] size The size of the buffer
+ *  \param[in] stats The RecurrentStatistics object to format
+ *  \param[in] style The layout used
+ *  \return FormatToNResult The end of the characters written and the size
+ *          needed to write the untruncated output
+ */
+template <class T, class U, class S>
+FormatToNResult format_to_n(char *out, const std::size_t size,
+                            const RecurrentStatistics<T, U, S> &stats,
+                            const FormatStyle style = FormatStyle::Multiline) {
+  const auto writer =
+      format_to(details::BoundedCharWriter{out, out + size, 0}, stats, style);
+  return {writer.out, writer.size};
+}
+
 /**
  *  \brief Format a RecurrentStatistics to a string
+ *
+ *  Arithmetic mean/variance types are written using format_to_n (a single
+ *  allocation), other types using their operator<<.
+ *
  *  \param[in] stats The RecurrentStatistics object to format
+ *  \param[in] style The layout used
  *  \return std::string The string format of the RecurrentStatistics
  */
 template <class T, class U, class S>
-std::string format(const RecurrentStatistics<T, U, S> &stats) {
-  constexpr const char *not_enough_samples = " -> Not enough samples yet";
+std::string format(const RecurrentStatistics<T, U, S> &stats,
+                   const FormatStyle style = FormatStyle::Multiline) {
+  if constexpr (details::is_to_chars_formattable<U>::value &&
+                details::is_to_chars_formattable<S>::value) {
+    // Large enough for any floating point type: a single allocation
+    char buffer[256];
+    const auto result = format_to_n(buffer, sizeof(buffer), stats, style);
+    if (result.size <= sizeof(buffer))
+      return std::string(buffer, result.out);
 
-  std::stringstream output;
-  const auto n = stats.getNumberOfMeasurements();
-  output << "Stats [N = " << n;
-  output << "]\nMean: " << stats.getMean();
+    std::string output;
+    output.reserve(result.size);
+    format_to(std::back_inserter(output), stats, style);
+    return output;
+  } else {
+    const auto n = stats.getNumberOfMeasurements();
+    const bool compact = (style == FormatStyle::Compact);
+    const char *not_available = compact ? "-" : " -> Not enough samples yet";
 
-  switch (n) {
-  case 0:
-    output << "\nVar : " << not_enough_samples;
-    output << "\nSVar: " << not_enough_samples;
-    break;
+    std::stringstream output;
+    output << (compact ? "N=" : "Stats [N = ") << n;
+    output << (compact ? " mean=" : "]\nMean: ") << stats.getMean();
 
-  case 1:
-    output << "\nVar : " << stats.getVariance();
-    output << "\nSVar: " << not_enough_samples;
-    break;
+    output << (compact ? " var=" : "\nVar : ");
+    if (n > 0)
+      output << stats.getVariance();
+    else
+      output << not_available;
 
-  default:
-    output << "\nVar : " << stats.getVariance();
-    output << "\nSVar: " << stats.getSampledVariance();
-  }
+    output << (compact ? " svar=" : "\nSVar: ");
+    if (n > 1)
+      output << stats.getSampledVariance();
+    else
+      output << not_available;
 
-  return output.str();
+    return output.str();
+  }
 }
 
 } // namespace stats
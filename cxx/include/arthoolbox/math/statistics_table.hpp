@@ -0,0 +1,297 @@
+#pragma once
+/**
+ *   \file statistics_table.hpp
+ *   \brief Contains a flat hash table of statistics, keyed by an id
+ */
+
+#include <algorithm>  // max, min
+#include <cstdint>    // uint64_t
+#include <cstdlib>    // std::size_t
+#include <functional> // hash
+#include <future>     // async
+#include <utility>    // pair
+#include <vector>
+
+#include "arthoolbox/execution.hpp"
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Open addressing (linear probing) hash table of recurrent statistics
+ *
+ *  Instead of one node per series (std::unordered_map<Key,
+ *  RecurrentStatistics>), the keys, counts, means and sums of squares are
+ *  stored in separate flat arrays (structure of arrays): looking up a key only
+ *  touches the keys/counts arrays, and no allocation happens outside of the
+ *  (amortized) growth.
+ *
+ *  A slot is empty when its count is 0. The capacity is a power of 2 and the
+ *  table grows when half full. Keys are never removed (except by clear()).
+ *
+ *  \notes This class is not thread safe !
+ *
+ *  \tparam Key The key type (default constructible, equality comparable)
+ *  \tparam T The measurement sample type (also used for the statistics)
+ *  \tparam Hash The hash function of Key
+ */
+template <class Key, class T = double, class Hash = std::hash<Key>>
+class StatisticsTable {
+public:
+  using statistics_type = RecurrentStatistics<T, T>;
+  using value_type = std::pair<Key, statistics_type>;
+
+  /**
+   *  \brief Construct the table
+   *  \param[in] capacity The number of keys to reserve space for
+   *  \param[in] hash The hash function used
+   */
+  explicit StatisticsTable(const std::size_t capacity = 0,
+                           const Hash &hash = Hash())
+      : hash_(hash), size_(0), shift_(64) {
+    reserve(capacity);
+  }
+
+  /**
+   *  \brief Get the number of keys recorded
+   *  \return std::size_t The number of keys
+   */
+  std::size_t size() const noexcept { return size_; }
+
+  /**
+   *  \brief Get the number of slots allocated
+   *  \return std::size_t The number of slots (0 or a power of 2)
+   */
+  std::size_t getCapacity() const noexcept { return counts_.size(); }
+
+  /**
+   *  \brief Remove all the keys (the memory is kept)
+   */
+  void clear() noexcept {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    size_ = 0;
+  }
+
+  /**
+   *  \brief Make sure number_of_keys keys can be recorded without growing
+   *  \param[in] number_of_keys The number of keys
+   */
+  void reserve(const std::size_t number_of_keys) {
+    if (number_of_keys == 0)
+      return;
+
+    std::size_t capacity = min_capacity;
+    while (capacity < 2 * number_of_keys)
+      capacity *= 2;
+
+    if (capacity > getCapacity())
+      rehash(capacity);
+  }
+
+  /**
+   *  \brief Update the statistics of key with a new measurement
+   *  \param[in] key The key of the series
+   *  \param[in] value The new measurement
+   */
+  void record(const Key &key, const T &value) {
+    if (2 * (size_ + 1) > getCapacity())
+      rehash(std::max(min_capacity, 2 * getCapacity()));
+
+    update(findOrInsert(key, slotOf(key)), value);
+  }
+
+  /**
+   *  \brief Update the statistics of keys[i] with values[i], for i < n
+   *
+   *  The slots of a block of keys are computed (and prefetched) before being
+   *  updated, hiding the cache misses of the random accesses.
+   *
+   *  \param[in] keys The keys of the series
+   *  \param[in] values The new measurements
+   *  \param[in] n The number of measurements
+   */
+  void record(const Key *keys, const T *values, const std::size_t n) {
+    std::size_t slots[batch_size];
+
+    for (std::size_t first = 0; first < n; first += batch_size) {
+      const auto count = std::min(batch_size, n - first);
+      if (2 * (size_ + count) > getCapacity())
+        reserve(size_ + count);
+
+      for (std::size_t i = 0; i < count; ++i) {
+        slots[i] = slotOf(keys[first + i]);
+        __builtin_prefetch(&keys_[slots[i]]);
+        __builtin_prefetch(&counts_[slots[i]]);
+      }
+
+      for (std::size_t i = 0; i < count; ++i)
+        update(findOrInsert(keys[first + i], slots[i]), values[first + i]);
+    }
+  }
+
+  /**
+   *  \brief Get the statistics of a key
+   *  \param[in] key The key of the series
+   *  \return statistics_type The statistics (N = 0 when key is unknown)
+   */
+  statistics_type getStatistics(const Key &key) const {
+    if (size_ == 0)
+      return statistics_type();
+
+    for (auto slot = slotOf(key); counts_[slot] != 0; slot = next(slot))
+      if (keys_[slot] == key)
+        return statistics(slot);
+
+    return statistics_type();
+  }
+
+  /**
+   *  \brief Call f(key, statistics) for each key recorded
+   *  \param[in] f The function called
+   */
+  template <class F> void forEach(F &&f) const {
+    for (std::size_t slot = 0; slot < getCapacity(); ++slot)
+      if (counts_[slot] != 0)
+        f(keys_[slot], statistics(slot));
+  }
+
+  /**
+   *  \brief Copy out the statistics of every key (in no particular order)
+   *  \return std::vector<value_type> The keys and their statistics
+   */
+  std::vector<value_type> snapshot(execution::sequenced_policy) const {
+    std::vector<value_type> out;
+    out.reserve(size_);
+    snapshotInto(out, 0, getCapacity());
+    return out;
+  }
+
+  /**
+   *  \brief Copy out the statistics of every key (in no particular order), in
+   *  parallel: each thread scans a contiguous range of slots
+   *  \param[in] policy The parallel policy
+   *  \return std::vector<value_type> The keys and their statistics
+   */
+  std::vector<value_type>
+  snapshot(const execution::parallel_policy &policy) const {
+    // Below this amount of slots per thread, spawning is not worth it
+    constexpr std::size_t min_chunk_size = 1 << 14;
+
+    const auto capacity = getCapacity();
+    const auto chunks = std::max<std::size_t>(
+        1, std::min(policy.concurrency(), capacity / min_chunk_size));
+    if (chunks == 1)
+      return snapshot(execution::seq);
+
+    const auto chunk_size = capacity / chunks;
+    std::vector<std::future<std::vector<value_type>>> partials;
+    partials.reserve(chunks - 1);
+
+    for (std::size_t i = 1; i < chunks; ++i) {
+      const auto first = i * chunk_size;
+      const auto last = (i + 1 == chunks) ? capacity : first + chunk_size;
+      partials.push_back(std::async(std::launch::async, [this, first, last] {
+        std::vector<value_type> partial;
+        snapshotInto(partial, first, last);
+        return partial;
+      }));
+    }
+
+    std::vector<value_type> out;
+    out.reserve(size_);
+    snapshotInto(out, 0, chunk_size);
+    for (auto &partial : partials) {
+      const auto values = partial.get();
+      out.insert(out.end(), values.begin(), values.end());
+    }
+
+    return out;
+  }
+
+private:
+  static constexpr std::size_t min_capacity = 16;
+  static constexpr std::size_t batch_size = 16;
+
+  /// Fibonacci hashing: spread the hash (std::hash is often the identity)
+  /// over the high bits, used as slot
+  std::size_t slotOf(const Key &key) const noexcept {
+    return static_cast<std::size_t>(
+        (static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull) >>
+        shift_);
+  }
+
+  std::size_t next(const std::size_t slot) const noexcept {
+    return (slot + 1) & (getCapacity() - 1);
+  }
+
+  std::size_t findOrInsert(const Key &key, std::size_t slot) {
+    for (; counts_[slot] != 0; slot = next(slot))
+      if (keys_[slot] == key)
+        return slot;
+
+    keys_[slot] = key;
+    means_[slot] = T{};
+    sum_squares_[slot] = T{};
+    ++size_;
+    return slot;
+  }
+
+  void update(const std::size_t slot, const T &value) noexcept {
+    const auto n = ++counts_[slot];
+    const auto new_mean = update_recurring_mean(value, means_[slot], n);
+    sum_squares_[slot] = update_recurring_sum_square(value, sum_squares_[slot],
+                                                     new_mean, means_[slot]);
+    means_[slot] = new_mean;
+  }
+
+  statistics_type statistics(const std::size_t slot) const {
+    return statistics_type(counts_[slot], means_[slot], sum_squares_[slot]);
+  }
+
+  void snapshotInto(std::vector<value_type> &out, const std::size_t first,
+                    const std::size_t last) const {
+    for (auto slot = first; slot < last; ++slot)
+      if (counts_[slot] != 0)
+        out.emplace_back(keys_[slot], statistics(slot));
+  }
+
+  void rehash(const std::size_t capacity) {
+    StatisticsTable other(0, hash_);
+    other.keys_.resize(capacity);
+    other.counts_.resize(capacity, 0);
+    other.means_.resize(capacity);
+    other.sum_squares_.resize(capacity);
+    other.shift_ = 64;
+    for (auto c = capacity; c > 1; c /= 2)
+      --other.shift_;
+
+    for (std::size_t slot = 0; slot < getCapacity(); ++slot) {
+      if (counts_[slot] == 0)
+        continue;
+
+      auto new_slot = other.slotOf(keys_[slot]);
+      while (other.counts_[new_slot] != 0)
+        new_slot = other.next(new_slot);
+
+      other.keys_[new_slot] = keys_[slot];
+      other.counts_[new_slot] = counts_[slot];
+      other.means_[new_slot] = means_[slot];
+      other.sum_squares_[new_slot] = sum_squares_[slot];
+    }
+
+    other.size_ = size_;
+    *this = std::move(other);
+  }
+
+  Hash hash_;                       /*!< Hold the hash function */
+  std::size_t size_;                /*!< Hold the number of keys */
+  unsigned shift_;                  /*!< Hold 64 - log2(capacity) */
+  std::vector<Key> keys_;           /*!< Hold the key of each slot */
+  std::vector<std::size_t> counts_; /*!< Hold N of each slot (0 = empty) */
+  std::vector<T> means_;            /*!< Hold the mean of each slot */
+  std::vector<T> sum_squares_;      /*!< Hold the sum of squares of slots */
+};
+
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,221 @@
+#pragma once
+/**
+ *   \file windowed_statistics.hpp
+ *   \brief Contains tools to perform statistics over a sliding window
+ */
+
+#include <array>   // array
+#include <cassert> // assert
+#include <cstdlib> // std::size_t
+
+#include "arthoolbox/math/statistics.hpp"
+
+namespace arthoolbox {
+namespace stats {
+
+/**
+ *  \brief Update the statistical mean of a sliding window
+ *
+ *  From the previous mean of the window (M_n-1), we compute the new mean (M_n)
+ *  when the oldest measurement (X_old) is replaced by a new one (X_n), with:
+ *  M_n = M_n-1 + (X_n - X_old)/N
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_sample The measurment X_old leaving the window
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \param[in] window_size The number of data N inside the window
+ *  \return U The new mean computed
+ */
+template <class T, class U = T>
+constexpr U update_sliding_mean(const T &new_sample, const T &old_sample,
+                                const U &old_mean,
+                                const std::size_t window_size) noexcept {
+  return (old_mean + (new_sample - old_sample) / window_size);
+}
+
+/**
+ *  \brief Update the statistical sum of squares of a sliding window
+ *
+ *  From the previous sum of squares of the window (SUM_n-1), using the n and
+ *  n-1 means (Mn, M_n-1), we compute the new sum of squares (SUM_n) when the
+ *  oldest measurement (X_old) is replaced by a new one (X_n), with:
+ *  SUM_n = SUM_n-1 + (X_n - X_old)*(X_n - M_n + X_old - M_n-1)
+ *
+ *  \note Rounding errors are never discarded from the window: over very long
+ *  runs, the sum may drift (and even become slightly negative for a constant
+ *  signal). WindowedStatistics periodically replaces it with an exact one.
+ *
+ *  \tparam T The measurment type
+ *  \tparam U The mean type
+ *  \tparam S The sum squares type
+ *
+ *  \param[in] new_sample The new measurment Xn
+ *  \param[in] old_sample The measurment X_old leaving the window
+ *  \param[in] old_sum_square The previously computed sum of squares SUM_n-1
+ *  \param[in] new_mean The new mean Mn
+ *  \param[in] old_mean The previously computed mean Mn-1
+ *  \return S The new sum of squares computed
+ */
+template <class T, class U = T, class S = T>
+constexpr S update_sliding_sum_square(const T &new_sample, const T &old_sample,
+                                      const S &old_sum_square,
+                                      const U &new_mean,
+                                      const U &old_mean) noexcept {
+  return (old_sum_square +
+          (new_sample - old_sample) *
+              (new_sample - new_mean + old_sample - old_mean));
+}
+
+/**
+ *  \brief Enables online statistics computation over the last N samples
+ *
+ *  The last N samples are kept inside a fixed size ring buffer. Each update
+ *  adds the new sample and removes the evicted one in constant time, without
+ *  any allocation.
+ *
+ *  To discard the rounding errors accumulated by the add/evict updates, each
+ *  sample also updates a second (recurrent) mean and sum of squares,
+ *  restarted every N samples. Once the whole window has been replaced, they
+ *  hold the exact statistics of the window and replace the sliding ones:
+ *  every update stays O(1), without any periodic pass over the window. In
+ *  between, the sum of squares is clamped to 0.
+ *
+ *  \notes This class is not thread safe !
+ *
+ *  \tparam T The measurement sample type
+ *  \tparam N The window size
+ *  \tparam U The mean type
+ *  \tparam S The variance type
+ */
+template <class T, std::size_t N, class U = T, class S = U>
+class WindowedStatistics {
+  static_assert(N > 0, "The window size must be > 0");
+
+public:
+  //! Default constructor
+  WindowedStatistics()
+      : samples_(), next_(0), number_of_measurements_(0), mean_(),
+        sum_square_(), exact_mean_(), exact_sum_square_(){};
+
+  /**
+   *  \brief Reset the statistics (N set to 0)
+   */
+  void reset() noexcept {
+    next_ = 0;
+    number_of_measurements_ = 0;
+    mean_ = U{};
+    sum_square_ = S{};
+  };
+
+  /**
+   *  \brief Get the size of the window
+   *  \return std::size_t N, the max number of measurement kept
+   */
+  static constexpr std::size_t getWindowSize() noexcept { return N; }
+
+  /**
+   *  \brief Get the number of measurement currently inside the window
+   *  \return std::size_t The number of measurment (<= N)
+   */
+  std::size_t getNumberOfMeasurements() const noexcept {
+    return number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the mean of the window
+   *  \return U The mean computed
+   */
+  U getMean() const noexcept { return mean_; }
+
+  /**
+   *  \brief Get the sum of squares of the window
+   *  \return S The sum of squares computed
+   */
+  S getSumSquare() const noexcept { return sum_square_; }
+
+  /**
+   *  \brief Get the variance of the window
+      \notes Number of measurement must be != 0
+   *  \return S the variance computed
+   */
+  S getVariance() const {
+    assert(number_of_measurements_ != 0 &&
+           "Need at least 1 measurement to compute the variance");
+    return sum_square_ / number_of_measurements_;
+  }
+
+  /**
+   *  \brief Get the sampled variance of the window
+      \notes Number of measurement must be > 1
+   *  \return S the sampled variance computed
+   */
+  S getSampledVariance() const {
+    assert(number_of_measurements_ > 1 &&
+           "Need at least 2 measurement to compute the sample variance");
+    return sum_square_ / (number_of_measurements_ - 1);
+  }
+
+  /**
+   *  \brief Update the window with a new measurement, evicting the oldest one
+   *         when the window is full
+   *  \param[in] new_data The new measurement use to update the data
+   */
+  void updateWith(const T &new_data) {
+    T &slot = samples_[next_];
+    updateExact(new_data, next_ + 1);
+    next_ = (next_ + 1) % N;
+
+    if (number_of_measurements_ < N) {
+      number_of_measurements_++;
+      const auto new_mean =
+          update_recurring_mean(new_data, mean_, number_of_measurements_);
+      sum_square_ =
+          update_recurring_sum_square(new_data, sum_square_, new_mean, mean_);
+      mean_ = new_mean;
+    } else {
+      const auto new_mean = update_sliding_mean(new_data, slot, mean_, N);
+      sum_square_ = update_sliding_sum_square(new_data, slot, sum_square_,
+                                              new_mean, mean_);
+      mean_ = new_mean;
+      if (sum_square_ < S{})
+        sum_square_ = S{};
+    }
+
+    slot = new_data;
+
+    // The whole window has been replaced since the exact stats restarted
+    if (next_ == 0) {
+      mean_ = exact_mean_;
+      sum_square_ = exact_sum_square_;
+    }
+  };
+
+private:
+  /// Update the exact stats of the samples written since the last restart
+  void updateExact(const T &new_data, const std::size_t n) {
+    if (n == 1) {
+      exact_mean_ = U{};
+      exact_sum_square_ = S{};
+    }
+
+    const auto new_mean = update_recurring_mean(new_data, exact_mean_, n);
+    exact_sum_square_ = update_recurring_sum_square(
+        new_data, exact_sum_square_, new_mean, exact_mean_);
+    exact_mean_ = new_mean;
+  }
+
+  std::array<T, N> samples_;   /*!< Ring buffer holding the window */
+  std::size_t next_;           /*!< Index of the next slot to overwrite */
+  std::size_t
+      number_of_measurements_; /*!< Hold the current number of measurment */
+  U mean_;                     /*!< Hold the currently computed mean */
+  S sum_square_;               /*!< Hold the sum square */
+  U exact_mean_;               /*!< Hold the mean since next_ was 0 */
+  S exact_sum_square_;         /*!< Hold the sum square since next_ was 0 */
+};
+
+} // namespace stats
+} // namespace arthoolbox
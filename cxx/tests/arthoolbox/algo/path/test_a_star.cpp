@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/algo/path/a_star.hpp"
+
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+namespace {
+
+// '#' are walls, S the start and G the goal
+const std::vector<std::string> map = {
+    "S....#....",
+    ".###.#.##.",
+    "...#...#..",
+    "##.#####.#",
+    "...#.....G",
+};
+
+using position_t = std::pair<int, int>;
+
+struct PositionHash {
+  std::size_t operator()(const position_t &position) const noexcept {
+    return std::hash<int>()(position.first * 1024 + position.second);
+  }
+};
+
+bool isFree(const position_t &position) {
+  return (position.first >= 0) and (position.first < int(map.size())) and
+         (position.second >= 0) and
+         (position.second < int(map[position.first].size())) and
+         (map[position.first][position.second] != '#');
+}
+
+std::vector<position_t> getNeighOf(const position_t &position) {
+  std::vector<position_t> neighbors;
+  for (const auto &move :
+       {position_t{-1, 0}, position_t{1, 0}, position_t{0, -1},
+        position_t{0, 1}}) {
+    const position_t neighbor{position.first + move.first,
+                              position.second + move.second};
+    if (isFree(neighbor))
+      neighbors.push_back(neighbor);
+  }
+  return neighbors;
+}
+
+const position_t start{0, 0};
+const position_t goal{4, 9};
+
+double manhattan(const position_t &position) {
+  return std::abs(position.first - goal.first) +
+         std::abs(position.second - goal.second);
+}
+
+void assertValidPath(const std::vector<position_t> &path,
+                     std::size_t expected_length) {
+  ASSERT_EQ(expected_length, path.size());
+  ASSERT_EQ(goal, path.front());
+  ASSERT_EQ(start, path.back());
+  for (std::size_t i = 1; i < path.size(); ++i) {
+    ASSERT_TRUE(isFree(path[i]));
+    ASSERT_EQ(1, std::abs(path[i].first - path[i - 1].first) +
+                     std::abs(path[i].second - path[i - 1].second));
+  }
+}
+
+TEST(AStar, StdFunction) {
+  const std::function<double(const position_t &)> heuristic = manhattan;
+  const std::function<std::vector<position_t>(const position_t &)> neighbors =
+      getNeighOf;
+
+  assertValidPath(aStarShortestPath<position_t, PositionHash>(
+                      start, goal, heuristic, neighbors),
+                  20);
+}
+
+TEST(AStar, Callables) {
+  // Unit distance neighbors
+  assertValidPath(aStarShortestPath<position_t, PositionHash>(
+                      start, goal, manhattan, getNeighOf),
+                  20);
+
+  // Weighted neighbors, from a lambda
+  const auto weighted = [](const position_t &position) {
+    std::vector<std::pair<position_t, double>> neighbors;
+    for (const auto &neighbor : getNeighOf(position))
+      neighbors.emplace_back(neighbor, 1.);
+    return neighbors;
+  };
+  assertValidPath(aStarShortestPath<position_t, PositionHash>(
+                      start, goal,
+                      [](const position_t &position) {
+                        return manhattan(position);
+                      },
+                      weighted),
+                  20);
+
+  // Unreachable goal
+  ASSERT_TRUE((aStarShortestPath<position_t, PositionHash>(
+                   start, position_t{0, 9}, manhattan,
+                   [](const position_t &position) {
+                     auto neighbors = getNeighOf(position);
+                     std::vector<position_t> out;
+                     for (const auto &neighbor : neighbors)
+                       if (neighbor.second < 5)
+                         out.push_back(neighbor);
+                     return out;
+                   })
+                   .empty()));
+}
+
+TEST(AStar, GraphConcept) {
+  const auto heuristic = [](const int &) { return 0.; };
+  const auto neighbors = [](const int &) { return std::vector<int>(); };
+  const auto weighted = [](const int &) {
+    return std::vector<std::pair<int, double>>();
+  };
+  const auto invalid = [](const int &) { return std::vector<std::string>(); };
+
+  static_assert(
+      details::is_a_star_graph<int, decltype(heuristic),
+                               decltype(neighbors)>::value,
+      "Unit distance neighbors");
+  static_assert(details::is_a_star_graph<int, decltype(heuristic),
+                                         decltype(weighted)>::value,
+                "Weighted neighbors");
+  static_assert(not details::is_a_star_graph<int, decltype(heuristic),
+                                             decltype(invalid)>::value,
+                "Invalid neighbors");
+  static_assert(not details::is_a_star_graph<int, decltype(neighbors),
+                                             decltype(neighbors)>::value,
+                "Invalid heuristic");
+}
+
+} // namespace
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
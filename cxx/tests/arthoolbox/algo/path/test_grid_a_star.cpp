@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/algo/path/a_star.hpp"
+#include "arthoolbox/algo/path/grid_a_star.hpp"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+namespace {
+
+std::vector<bool> generateWalls(const std::size_t number_of_cells,
+                                const double wall_ratio,
+                                const unsigned seed) {
+  std::mt19937 random_generator(seed);
+  std::bernoulli_distribution is_wall(wall_ratio);
+  std::vector<bool> walls(number_of_cells);
+  for (std::size_t i = 0; i < walls.size(); ++i)
+    walls[i] = is_wall(random_generator);
+  return walls;
+}
+
+template <std::size_t Dim>
+void assertValidPath(const GridAStar<Dim> &engine,
+                     const std::vector<bool> &walls,
+                     const std::vector<std::size_t> &path) {
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    ASSERT_FALSE(walls[path[i]]);
+    if (i == 0)
+      continue;
+
+    const auto lhs = engine.toCell(path[i - 1]);
+    const auto rhs = engine.toCell(path[i]);
+    std::size_t distance = 0;
+    for (std::size_t d = 0; d < Dim; ++d)
+      distance += (lhs[d] > rhs[d]) ? lhs[d] - rhs[d] : rhs[d] - lhs[d];
+    ASSERT_EQ(1u, distance);
+  }
+}
+
+TEST(GridAStar, Indexes) {
+  GridAStar<3> engine({4, 5, 6});
+  ASSERT_EQ(120u, engine.getNumberOfCells());
+  ASSERT_EQ(0u, engine.toIndex({0, 0, 0}));
+  ASSERT_EQ(1u + 2 * 4 + 3 * 20, engine.toIndex({1, 2, 3}));
+  for (std::size_t i = 0; i < engine.getNumberOfCells(); ++i)
+    ASSERT_EQ(i, engine.toIndex(engine.toCell(i)));
+}
+
+TEST(GridAStar, SameLengthThanAStar) {
+  constexpr std::size_t size = 64;
+  GridAStar<2> engine({size, size});
+
+  // The engine is reused across all the queries
+  std::vector<std::size_t> path;
+  for (unsigned seed = 0; seed < 10; ++seed) {
+    auto walls = generateWalls(size * size, 0.3, seed);
+    walls.front() = walls.back() = false;
+    const auto isFree = [&walls](std::size_t index) {
+      return not walls[index];
+    };
+
+    const auto neighbors = [&walls](const std::size_t &index) {
+      std::vector<std::size_t> out;
+      const auto x = index % size, y = index / size;
+      if ((x > 0) and not walls[index - 1])
+        out.push_back(index - 1);
+      if ((x + 1 < size) and not walls[index + 1])
+        out.push_back(index + 1);
+      if ((y > 0) and not walls[index - size])
+        out.push_back(index - size);
+      if ((y + 1 < size) and not walls[index + size])
+        out.push_back(index + size);
+      return out;
+    };
+    const auto manhattan = [](const std::size_t &index) {
+      return double((size - 1 - index % size) + (size - 1 - index / size));
+    };
+
+    const auto expected = aStarShortestPath<std::size_t>(
+        0, size * size - 1, manhattan, neighbors);
+
+    const bool found =
+        engine.shortestPath({0, 0}, {size - 1, size - 1}, isFree, path);
+    ASSERT_EQ(not expected.empty(), found);
+    ASSERT_EQ(expected.size(), path.size());
+    if (found) {
+      ASSERT_EQ(0u, path.back());
+      ASSERT_EQ(size * size - 1, path.front());
+      assertValidPath(engine, walls, path);
+    }
+  }
+}
+
+TEST(GridAStar, ThreeDimensions) {
+  GridAStar<3> engine({8, 8, 8});
+  std::vector<bool> walls(engine.getNumberOfCells(), false);
+
+  // Wall on the z = 4 plane, except one hole at (7, 7, 4)
+  for (std::size_t x = 0; x < 8; ++x)
+    for (std::size_t y = 0; y < 8; ++y)
+      walls[engine.toIndex({x, y, 4})] = not((x == 7) and (y == 7));
+
+  const auto isFree = [&walls](std::size_t index) { return not walls[index]; };
+  const auto path = engine.shortestPath({0, 0, 0}, {0, 0, 7}, isFree);
+  ASSERT_EQ(7u + 7 + 7 + 7 + 7 + 1, path.size());
+  ASSERT_EQ((GridAStar<3>::cell_type{0, 0, 0}), path.back());
+  ASSERT_EQ((GridAStar<3>::cell_type{0, 0, 7}), path.front());
+
+  // Closing the hole
+  walls[engine.toIndex({7, 7, 4})] = true;
+  ASSERT_TRUE(engine.shortestPath({0, 0, 0}, {0, 0, 7}, isFree).empty());
+
+  // Trivial path
+  ASSERT_EQ(1u, engine.shortestPath({1, 2, 3}, {1, 2, 3}, isFree).size());
+}
+
+} // namespace
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/algo/path/a_star.hpp"
+#include "arthoolbox/algo/path/path_searcher.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) and not defined(__clang__)
+// False positive: the replaced operator delete matches the operator new
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Count the allocations performed by this test executable
+static std::atomic<std::size_t> allocations{0};
+
+void *operator new(std::size_t size) {
+  ++allocations;
+  if (void *p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace arthoolbox {
+namespace algo {
+namespace path {
+namespace {
+
+constexpr int size = 64;
+
+/// Grid with random walls (fixed seed), providing its neighbors through a
+/// reused buffer
+struct Grid {
+  explicit Grid(const unsigned seed) : walls(size * size) {
+    std::mt19937 random_generator(seed);
+    std::bernoulli_distribution is_wall(0.3);
+    for (auto &&wall : walls)
+      wall = is_wall(random_generator);
+    walls.front() = walls.back() = false;
+    buffer.reserve(4);
+  }
+
+  double manhattan(const int cell, const int goal) const {
+    return std::abs(cell % size - goal % size) +
+           std::abs(cell / size - goal / size);
+  }
+
+  const std::vector<std::pair<int, double>> &neighbors(const int cell) {
+    buffer.clear();
+    const int x = cell % size, y = cell / size;
+    if ((x > 0) and not walls[cell - 1])
+      buffer.emplace_back(cell - 1, 1.);
+    if ((x + 1 < size) and not walls[cell + 1])
+      buffer.emplace_back(cell + 1, 1.);
+    if ((y > 0) and not walls[cell - size])
+      buffer.emplace_back(cell - size, 1.);
+    if ((y + 1 < size) and not walls[cell + size])
+      buffer.emplace_back(cell + size, 1.);
+    return buffer;
+  }
+
+  std::vector<bool> walls;
+  std::vector<std::pair<int, double>> buffer;
+};
+
+TEST(PathSearcher, SameLengthThanAStar) {
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+
+  for (unsigned seed = 0; seed < 10; ++seed) {
+    Grid grid(seed);
+    const int goal = size * size - 1;
+    const auto heuristic = [&grid, goal](const int &cell) {
+      return grid.manhattan(cell, goal);
+    };
+    const auto neighbors = [&grid](const int &cell) {
+      return grid.neighbors(cell);
+    };
+
+    const auto expected =
+        aStarShortestPath<int>(0, goal, heuristic, neighbors);
+    ASSERT_EQ(not expected.empty(),
+              searcher.shortestPath(0, goal, heuristic, neighbors, path));
+    ASSERT_EQ(expected.size(), path.size());
+    if (not path.empty()) {
+      ASSERT_EQ(0, path.back());
+      ASSERT_EQ(goal, path.front());
+    }
+
+    // Consistent heuristic: each node is expanded at most once, and there is
+    // no duplicate inside the open list
+    ASSERT_LE(searcher.getNumberOfExpansions(), searcher.getNumberOfNodes());
+    ASSERT_LE(searcher.getOpenListHighWaterMark(),
+              searcher.getNumberOfNodes());
+    ASSERT_NE(0u, searcher.getOpenListHighWaterMark());
+  }
+
+  // Unit distance neighbors, one shot overload
+  ASSERT_EQ((std::vector<int>{3, 2, 1, 0}),
+            searcher.shortestPath(
+                0, 3, [](const int &cell) { return 3. - cell; },
+                [](const int &cell) { return std::vector<int>{cell + 1}; }));
+}
+
+TEST(PathSearcher, BidirectionalSameLengthThanAStar) {
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+
+  for (unsigned seed = 0; seed < 10; ++seed) {
+    Grid grid(seed);
+    const int goal = size * size - 1;
+    const auto heuristic_from = [&grid, goal](const int &cell) {
+      return grid.manhattan(cell, goal);
+    };
+    const auto heuristic_to = [&grid](const int &cell) {
+      return grid.manhattan(0, cell);
+    };
+    const auto neighbors = [&grid](const int &cell) {
+      return grid.neighbors(cell);
+    };
+
+    const auto expected = searcher.shortestPath(0, goal, heuristic_from,
+                                                neighbors);
+    ASSERT_EQ(not expected.empty(),
+              searcher.bidirectionalShortestPath(0, goal, heuristic_from,
+                                                 heuristic_to, neighbors,
+                                                 neighbors, path));
+    ASSERT_EQ(expected.size(), path.size());
+    if (not path.empty()) {
+      ASSERT_EQ(0, path.back());
+      ASSERT_EQ(goal, path.front());
+      for (std::size_t i = 1; i < path.size(); ++i)
+        ASSERT_TRUE((std::abs(path[i] - path[i - 1]) == 1) or
+                    (std::abs(path[i] - path[i - 1]) == size));
+    }
+  }
+
+  // Same start and goal
+  ASSERT_EQ((std::vector<int>{5}),
+            searcher.bidirectionalShortestPath(
+                5, 5, [](const int &) { return 0.; },
+                [](const int &) { return 0.; },
+                [](const int &cell) { return std::vector<int>{cell + 1}; },
+                [](const int &cell) { return std::vector<int>{cell - 1}; }));
+}
+
+TEST(PathSearcher, BidirectionalDirectedGraph) {
+  // One way ring 0 -> 1 -> ... -> 19 -> 0 with unit distances, plus
+  // shortcuts i -> i + 5 costing 3
+  constexpr int nodes = 20;
+  const auto successors = [](const int &node) {
+    return std::vector<std::pair<int, double>>{{(node + 1) % nodes, 1.},
+                                               {(node + 5) % nodes, 3.}};
+  };
+  const auto predecessors = [](const int &node) {
+    return std::vector<std::pair<int, double>>{
+        {(node + nodes - 1) % nodes, 1.}, {(node + nodes - 5) % nodes, 3.}};
+  };
+  const auto none = [](const int &) { return 0.; };
+
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+  for (int goal = 0; goal < nodes; ++goal) {
+    // As many shortcuts as possible (e.g. 3 shortcuts + 2 steps for 17)
+    const double expected = 3. * (goal / 5) + goal % 5;
+
+    ASSERT_TRUE(searcher.bidirectionalShortestPath(3, (3 + goal) % nodes,
+                                                   none, none, successors,
+                                                   predecessors, path));
+    ASSERT_EQ(3, path.back());
+    ASSERT_EQ((3 + goal) % nodes, path.front());
+
+    double distance = 0.;
+    for (std::size_t i = path.size() - 1; i > 0; --i)
+      distance += ((path[i] + 1) % nodes == path[i - 1]) ? 1. : 3.;
+    ASSERT_DOUBLE_EQ(expected, distance);
+  }
+
+  // One way path 0 -> 1 -> ... -> 9 can't be walked backward
+  ASSERT_FALSE(searcher.bidirectionalShortestPath(
+      5, 2, none, none,
+      [](const int &node) {
+        return node < 9 ? std::vector<int>{node + 1} : std::vector<int>{};
+      },
+      [](const int &node) {
+        return node > 0 ? std::vector<int>{node - 1} : std::vector<int>{};
+      },
+      path));
+  ASSERT_TRUE(path.empty());
+}
+
+TEST(PathSearcher, NoAllocationOnceWarm) {
+  Grid grid(0);
+  PathSearcher<int> searcher;
+  std::vector<int> path;
+
+  const auto neighbors = [&grid](const int &cell) -> const auto & {
+    return grid.neighbors(cell);
+  };
+
+  // Warm up: the workspace grows to the size of the largest query
+  std::vector<int> goals;
+  for (int goal = size * size - 1; goal > 0; goal -= 397)
+    if (not grid.walls[goal])
+      goals.push_back(goal);
+
+  for (const auto goal : goals) {
+    searcher.shortestPath(
+        0, goal, [&grid, goal](const int &cell) {
+          return grid.manhattan(cell, goal);
+        },
+        neighbors, path);
+  }
+
+  const auto before = allocations.load();
+  std::size_t found = 0;
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    for (const auto goal : goals) {
+      found += searcher.shortestPath(
+          0, goal, [&grid, goal](const int &cell) {
+            return grid.manhattan(cell, goal);
+          },
+          neighbors, path);
+    }
+  }
+  ASSERT_EQ(before, allocations.load());
+  ASSERT_NE(0u, found);
+}
+
+} // namespace
+} // namespace path
+} // namespace algo
+} // namespace arthoolbox
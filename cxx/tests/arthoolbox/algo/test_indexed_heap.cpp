@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/algo/indexed_heap.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+namespace arthoolbox {
+namespace algo {
+namespace {
+
+TEST(IndexedHeap, PushDecreasePop) {
+  IndexedHeap<double> heap;
+  ASSERT_TRUE(heap.empty());
+
+  heap.push(3, 30.);
+  heap.push(1, 10.);
+  heap.push(7, 70.);
+  heap.push(0, 5.);
+  ASSERT_EQ(4u, heap.size());
+  ASSERT_TRUE(heap.contains(7));
+  ASSERT_FALSE(heap.contains(2));
+  ASSERT_FALSE(heap.contains(1000));
+  ASSERT_EQ(0u, heap.top());
+
+  heap.decrease(7, 1.);
+  ASSERT_EQ(7u, heap.top());
+  ASSERT_EQ(1., heap.getKey(7));
+
+  ASSERT_FALSE(heap.pushOrDecrease(3, 2.));
+  ASSERT_TRUE(heap.pushOrDecrease(2, 20.));
+  ASSERT_EQ(5u, heap.getHighWaterMark());
+
+  ASSERT_EQ(7u, heap.pop());
+  ASSERT_EQ(3u, heap.pop());
+  ASSERT_EQ(0u, heap.pop());
+  ASSERT_EQ(1u, heap.pop());
+  ASSERT_FALSE(heap.contains(1));
+  ASSERT_EQ(1u, heap.size());
+  ASSERT_EQ(5u, heap.getHighWaterMark());
+
+  heap.clear();
+  ASSERT_TRUE(heap.empty());
+  ASSERT_FALSE(heap.contains(2));
+  ASSERT_EQ(0u, heap.getHighWaterMark());
+
+  // Max heap
+  IndexedHeap<int, 2, std::greater<int>> max_heap;
+  max_heap.push(0, 1);
+  max_heap.push(1, 3);
+  max_heap.push(2, 2);
+  ASSERT_EQ(1u, max_heap.pop());
+  ASSERT_EQ(2u, max_heap.pop());
+  ASSERT_EQ(0u, max_heap.pop());
+}
+
+template <std::size_t Arity> void checkAgainstReference() {
+  std::mt19937 random_generator(42);
+  std::uniform_int_distribution<std::uint32_t> id_distribution(0, 999);
+  std::uniform_int_distribution<int> key_distribution(0, 100000);
+
+  IndexedHeap<int, Arity> heap;
+  std::map<std::uint32_t, int> keys;
+  std::set<std::pair<int, std::uint32_t>> reference;
+  std::size_t high_water_mark = 0;
+
+  for (int i = 0; i < 20000; ++i) {
+    const auto id = id_distribution(random_generator);
+    auto key = key_distribution(random_generator);
+
+    if ((i % 3 == 0) and not reference.empty()) {
+      const auto expected_key = reference.begin()->first;
+      const auto popped = heap.pop();
+      ASSERT_EQ(expected_key, keys[popped]);
+      reference.erase({keys[popped], popped});
+      keys.erase(popped);
+    } else if (keys.count(id) != 0) {
+      if (key < keys[id]) {
+        reference.erase({keys[id], id});
+        heap.decrease(id, key);
+        keys[id] = key;
+        reference.emplace(key, id);
+      }
+    } else {
+      heap.push(id, key);
+      keys[id] = key;
+      reference.emplace(key, id);
+    }
+
+    high_water_mark = std::max(high_water_mark, reference.size());
+    ASSERT_EQ(reference.size(), heap.size());
+    ASSERT_EQ(high_water_mark, heap.getHighWaterMark());
+  }
+
+  while (not reference.empty()) {
+    ASSERT_EQ(reference.begin()->first, keys[heap.pop()]);
+    reference.erase(reference.begin());
+  }
+  ASSERT_TRUE(heap.empty());
+}
+
+TEST(IndexedHeap, Binary) { checkAgainstReference<2>(); }
+TEST(IndexedHeap, Quaternary) { checkAgainstReference<4>(); }
+TEST(IndexedHeap, Octonary) { checkAgainstReference<8>(); }
+
+} // namespace
+} // namespace algo
+} // namespace arthoolbox
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/accumulator.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+using namespace features;
+
+TEST(Accumulator, OnlyPayForWhatYouUse) {
+  static_assert(sizeof(Accumulator<double, Min>) == sizeof(double));
+  static_assert(sizeof(Accumulator<double, Min, Max>) == 2 * sizeof(double));
+  static_assert(sizeof(Accumulator<float, Count>) == sizeof(std::size_t));
+
+  // Dependencies are added implicitly
+  using variance_only = Accumulator<double, Variance>;
+  static_assert(variance_only::with_variance && variance_only::with_mean &&
+                variance_only::with_count);
+  static_assert(not variance_only::with_sum && not variance_only::with_min &&
+                not variance_only::with_max);
+}
+
+TEST(Accumulator, AllFeatures) {
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(50, 5e-3);
+
+  std::vector<double> samples(5000);
+  std::generate(samples.begin(), samples.end(),
+                [&distribution, &random_generator]() {
+                  return distribution(random_generator);
+                });
+
+  Accumulator<double, Count, Sum, Min, Max, Mean, Variance> accumulator;
+  RecurrentStatistics<double, double> reference;
+  for (const auto &sample : samples) {
+    accumulator.updateWith(sample);
+    reference.updateWith(sample);
+  }
+
+  ASSERT_EQ(accumulator.getNumberOfMeasurements(), samples.size());
+  ASSERT_DOUBLE_EQ(accumulator.getSum(),
+                   std::accumulate(samples.cbegin(), samples.cend(), 0.));
+  ASSERT_EQ(accumulator.getMin(),
+            *std::min_element(samples.cbegin(), samples.cend()));
+  ASSERT_EQ(accumulator.getMax(),
+            *std::max_element(samples.cbegin(), samples.cend()));
+  ASSERT_EQ(accumulator.getMean(), reference.getMean());
+  ASSERT_EQ(accumulator.getVariance(), reference.getVariance());
+  ASSERT_EQ(accumulator.getSampledVariance(), reference.getSampledVariance());
+
+  // Merging two halves gives the same results
+  decltype(accumulator) lhs, rhs;
+  for (std::size_t i = 0; i < samples.size(); ++i)
+    (i < 1234 ? lhs : rhs).updateWith(samples[i]);
+  lhs.merge(rhs);
+
+  ASSERT_EQ(lhs.getNumberOfMeasurements(), samples.size());
+  ASSERT_NEAR(lhs.getSum(), accumulator.getSum(), 1e-9);
+  ASSERT_EQ(lhs.getMin(), accumulator.getMin());
+  ASSERT_EQ(lhs.getMax(), accumulator.getMax());
+  ASSERT_NEAR(lhs.getMean(), accumulator.getMean(), 1e-9);
+  ASSERT_NEAR(lhs.getVariance(), accumulator.getVariance(), 1e-9);
+
+  accumulator.reset();
+  ASSERT_EQ(accumulator.getNumberOfMeasurements(), 0);
+}
+
+TEST(Accumulator, MinMax) {
+  Accumulator<int, Min, Max> accumulator;
+  for (const int value : {3, -1, 4, 1, -5, 9, 2, 6})
+    accumulator.updateWith(value);
+
+  ASSERT_EQ(accumulator.getMin(), -5);
+  ASSERT_EQ(accumulator.getMax(), 9);
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
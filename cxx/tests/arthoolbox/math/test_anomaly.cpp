@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/anomaly.hpp"
+#include "arthoolbox/math/exponential_statistics.hpp"
+#include "arthoolbox/math/statistics.hpp"
+#include "arthoolbox/math/windowed_statistics.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(ZScoreDetector, WarmUpAndThreshold) {
+  ZScoreDetector<RecurrentStatistics<double, double>> detector(
+      RecurrentStatistics<double, double>(), 3., 3., 10);
+
+  // Nothing is flagged during the warm up
+  ASSERT_FALSE(detector.updateWith(0.));
+  ASSERT_FALSE(detector.updateWith(1000.));
+  for (int i = 0; i < 8; ++i)
+    ASSERT_FALSE(detector.updateWith(i % 2 ? 1. : -1.));
+  ASSERT_EQ(10u, detector.getStatistics().getNumberOfMeasurements());
+
+  const auto mean = detector.getStatistics().getMean();
+  const auto stddev = std::sqrt(detector.getStatistics().getVariance());
+  ASSERT_FALSE(detector.updateWith(mean + 2.9 * stddev));
+  ASSERT_FALSE(detector.isAnomalous());
+  ASSERT_TRUE(detector.updateWith(-1e6));
+  ASSERT_TRUE(detector.isAnomalous());
+  ASSERT_EQ(1u, detector.getNumberOfAnomalies());
+}
+
+TEST(ZScoreDetector, HysteresisAndCallback) {
+  std::vector<std::pair<bool, double>> events;
+  const auto callback = [&events](bool anomalous, double sample) {
+    events.emplace_back(anomalous, sample);
+  };
+
+  // Windowed statistics fed with alternating +/-1: mean 0 and stddev 1
+  ZScoreDetector<WindowedStatistics<double, 100>, decltype(callback)>
+      detector(WindowedStatistics<double, 100>(), 3., 1., 2, callback);
+  for (int i = 0; i < 100; ++i)
+    detector.updateWith(i % 2 ? 1. : -1.);
+  ASSERT_TRUE(events.empty());
+
+  // Enter above 3 sigma, stay anomalous until below 1 sigma
+  ASSERT_TRUE(detector.updateWith(5.));
+  ASSERT_TRUE(detector.updateWith(2.5));
+  ASSERT_TRUE(detector.updateWith(-2.));
+  ASSERT_FALSE(detector.updateWith(0.5));
+  ASSERT_FALSE(detector.updateWith(2.5));
+  ASSERT_EQ(3u, detector.getNumberOfAnomalies());
+
+  ASSERT_EQ(2u, events.size());
+  ASSERT_TRUE(events[0].first);
+  ASSERT_EQ(5., events[0].second);
+  ASSERT_FALSE(events[1].first);
+  ASSERT_EQ(0.5, events[1].second);
+}
+
+TEST(ZScoreDetector, WarmUpLongerThanWindow) {
+  // The window never holds more than 10 samples: the warm up is clamped to it
+  ZScoreDetector<WindowedStatistics<double, 10>> detector(
+      WindowedStatistics<double, 10>(), 3., 3., 50);
+  for (int i = 0; i < 10; ++i)
+    ASSERT_FALSE(detector.updateWith(i % 2 ? 1. : -1.));
+
+  ASSERT_TRUE(detector.updateWith(100.));
+}
+
+TEST(ZScoreDetector, ExponentialStatistics) {
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(100, 1);
+
+  ZScoreDetector<ExponentialStatistics<double>> detector(
+      ExponentialStatistics<double>(0.01), 6., 6., 100);
+
+  // Slow drift: the EWMA follows it, no anomaly
+  for (int i = 0; i < 10000; ++i)
+    detector.updateWith(distribution(random_generator) + i * 1e-3);
+  ASSERT_EQ(0u, detector.getNumberOfAnomalies());
+
+  // Step
+  ASSERT_TRUE(detector.updateWith(150.));
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
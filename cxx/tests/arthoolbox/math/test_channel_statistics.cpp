@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/iterator.hpp"
+#include "arthoolbox/math/channel_statistics.hpp"
+#include "arthoolbox/math/statistics.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+constexpr std::size_t Channels = 16;
+constexpr std::size_t Frames = 1000;
+
+struct ChannelStatisticsTest : public ::testing::Test {
+  void SetUp() override {
+    std::mt19937 random_generator(42);
+    std::normal_distribution<double> distribution(0, 1);
+
+    interleaved.resize(Frames * Channels);
+    planar.resize(Frames * Channels);
+    for (std::size_t f = 0; f < Frames; ++f) {
+      for (std::size_t c = 0; c < Channels; ++c) {
+        const auto value = 10. * c + (c + 1) * distribution(random_generator);
+        interleaved[f * Channels + c] = value;
+        planar[c * Frames + f] = value;
+        references[c].updateWith(value);
+      }
+    }
+  }
+
+  template <class Stats> void check(const Stats &stats) const {
+    ASSERT_EQ(stats.getNumberOfMeasurements(), Frames);
+    for (std::size_t c = 0; c < Channels; ++c) {
+      ASSERT_NEAR(stats.getMean(c), references[c].getMean(), 1e-9);
+      ASSERT_NEAR(stats.getVariance(c), references[c].getVariance(), 1e-9);
+      ASSERT_NEAR(stats.getSampledVariance(c),
+                  references[c].getSampledVariance(), 1e-9);
+    }
+  }
+
+  std::vector<double> interleaved;
+  std::vector<double> planar;
+  std::array<RecurrentStatistics<double, double>, Channels> references;
+};
+
+TEST_F(ChannelStatisticsTest, InterleavedFrames) {
+  ChannelStatistics<double, Channels> one_by_one;
+  for (std::size_t f = 0; f < Frames; ++f)
+    one_by_one.updateWith(interleaved.data() + f * Channels);
+  check(one_by_one);
+
+  ChannelStatistics<double, Channels> all_at_once;
+  all_at_once.updateWith(interleaved.data(), Frames);
+  check(all_at_once);
+
+  all_at_once.reset();
+  ASSERT_EQ(all_at_once.getNumberOfMeasurements(), 0);
+}
+
+TEST_F(ChannelStatisticsTest, PlanarFrames) {
+  ChannelStatistics<double, Channels> stats;
+  for (std::size_t f = 0; f < Frames; ++f)
+    stats.updateWith(iterator::strided_iterator<const double *>(
+        planar.data() + f, Frames));
+  check(stats);
+}
+
+TEST_F(ChannelStatisticsTest, Merge) {
+  ChannelStatistics<double, Channels> lhs, rhs;
+  lhs.updateWith(interleaved.data(), 123);
+  rhs.updateWith(interleaved.data() + 123 * Channels, Frames - 123);
+  check(lhs.merge(rhs));
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/covariance.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+constexpr std::size_t Dim = 6;
+using sample_t = std::array<double, Dim>;
+
+struct Covariance : public ::testing::Test {
+  static void SetUpTestSuite() {
+    std::mt19937 random_generator(42);
+    std::normal_distribution<double> distribution(0, 1);
+
+    // Correlated channels: x_i = noise_i + i * common
+    for (std::size_t n = 0; n < 5000; ++n) {
+      const auto common = distribution(random_generator);
+      sample_t sample;
+      for (std::size_t i = 0; i < Dim; ++i)
+        sample[i] = 100. + distribution(random_generator) + i * common;
+      samples.push_back(sample);
+    }
+
+    mean.fill(0);
+    for (const auto &sample : samples)
+      for (std::size_t i = 0; i < Dim; ++i)
+        mean[i] += sample[i] / samples.size();
+
+    covariance.fill(0);
+    for (const auto &sample : samples)
+      for (std::size_t i = 0; i < Dim; ++i)
+        for (std::size_t j = 0; j < Dim; ++j)
+          covariance[i * Dim + j] +=
+              (sample[i] - mean[i]) * (sample[j] - mean[j]) / samples.size();
+  }
+
+  static std::vector<sample_t> samples;
+  static sample_t mean;
+  static std::array<double, Dim * Dim> covariance;
+};
+
+std::vector<sample_t> Covariance::samples;
+sample_t Covariance::mean;
+std::array<double, Dim * Dim> Covariance::covariance;
+
+TEST_F(Covariance, RecurrentCovariance) {
+  RecurrentCovariance<double, Dim> statistician;
+  for (const auto &sample : samples)
+    statistician.updateWith(sample);
+
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), samples.size());
+
+  const auto computed = statistician.getCovariance();
+  for (std::size_t i = 0; i < Dim; ++i) {
+    ASSERT_NEAR(statistician.getMean()[i], mean[i], 1e-9);
+    for (std::size_t j = 0; j < Dim; ++j) {
+      ASSERT_NEAR(computed[i * Dim + j], covariance[i * Dim + j], 1e-9);
+      ASSERT_EQ(statistician.getCovariance(i, j), computed[i * Dim + j]);
+    }
+  }
+
+  statistician.reset();
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 0);
+}
+
+TEST_F(Covariance, RecurrentCovarianceMerge) {
+  RecurrentCovariance<double, Dim> lhs, rhs, empty;
+  for (std::size_t n = 0; n < samples.size(); ++n)
+    (n < 1234 ? lhs : rhs).updateWith(samples[n].data());
+
+  empty.merge(lhs);
+  empty.merge(rhs);
+  ASSERT_EQ(empty.getNumberOfMeasurements(), samples.size());
+
+  const auto computed = empty.getSampledCovariance();
+  const auto correction = samples.size() / (samples.size() - 1.);
+  for (std::size_t i = 0; i < Dim; ++i) {
+    ASSERT_NEAR(empty.getMean()[i], mean[i], 1e-9);
+    for (std::size_t j = 0; j < Dim; ++j)
+      ASSERT_NEAR(computed[i * Dim + j], covariance[i * Dim + j] * correction,
+                  1e-9);
+  }
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/exponential_statistics.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(ExponentialStatistics, FreeFunctions) {
+  static_assert(update_exponential_mean(10., 0., 0.5) == 5.);
+  static_assert(update_exponential_variance(10., 0., 0., 0.5) == 25.);
+
+  ASSERT_DOUBLE_EQ(half_life_to_alpha<double>(std::chrono::seconds(1),
+                                              std::chrono::seconds(1)),
+                   0.5);
+  ASSERT_DOUBLE_EQ(half_life_to_alpha<double>(std::chrono::milliseconds(2000),
+                                              std::chrono::seconds(1)),
+                   0.75);
+  ASSERT_DOUBLE_EQ(half_life_to_alpha<double>(std::chrono::seconds(0),
+                                              std::chrono::seconds(1)),
+                   0.);
+}
+
+TEST(ExponentialStatistics, MatchesTheWeightedDefinition) {
+  constexpr double alpha = 0.1;
+  const std::vector<double> samples = {3., 1., 4., 1., 5., 9., 2., 6., 5., 3.};
+
+  ExponentialStatistics<double> statistician(alpha);
+  for (const auto &sample : samples)
+    statistician.updateWith(sample);
+
+  // Weights: (1 - alpha)^(n-1) for the first sample, alpha * (1 - alpha)^k for
+  // the others
+  std::vector<double> weights(samples.size());
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    const auto age = samples.size() - 1 - i;
+    weights[i] = (i == 0 ? 1. : alpha) * std::pow(1 - alpha, age);
+  }
+
+  double mean = 0;
+  for (std::size_t i = 0; i < samples.size(); ++i)
+    mean += weights[i] * samples[i];
+
+  double variance = 0;
+  for (std::size_t i = 0; i < samples.size(); ++i)
+    variance += weights[i] * std::pow(samples[i] - mean, 2);
+
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), samples.size());
+  ASSERT_NEAR(statistician.getMean(), mean, 1e-12);
+  ASSERT_NEAR(statistician.getVariance(), variance, 1e-12);
+
+  statistician.reset();
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 0);
+}
+
+TEST(ExponentialStatistics, IsConstexpr) {
+  constexpr auto statistician = [] {
+    ExponentialStatistics<double> stats(0.5);
+    stats.updateWith(0.);
+    stats.updateWith(10.);
+    return stats;
+  }();
+
+  static_assert(statistician.getMean() == 5.);
+  static_assert(statistician.getVariance() == 25.);
+}
+
+TEST(TimeDecayedStatistics, IrregularTimestamps) {
+  using namespace std::chrono_literals;
+  using time_point = std::chrono::steady_clock::time_point;
+
+  TimeDecayedStatistics<double> statistician(1s);
+  ASSERT_EQ(statistician.getHalfLife(), 1s);
+
+  ASSERT_TRUE(statistician.updateWith(0., time_point(0s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 0.);
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 1);
+
+  // One half-life later: both measurements weight the same
+  ASSERT_TRUE(statistician.updateWith(10., time_point(1s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 5.);
+  ASSERT_DOUBLE_EQ(statistician.getVariance(), 25.);
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 2);
+
+  // Two half-lives later: the new measurement weights 3/4
+  ASSERT_TRUE(statistician.updateWith(9., time_point(3s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 8.);
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 3);
+
+  // Same timestamp: {9, 7} share the 3/4 weight
+  ASSERT_TRUE(statistician.updateWith(7., time_point(3s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 5. + 0.75 * (8. - 5.));
+  ASSERT_DOUBLE_EQ(statistician.getVariance(),
+                   0.25 * (25. + 0.75 * 9.) + 0.75 * 1.);
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 4);
+
+  // Out of order measurements are ignored, and not counted
+  ASSERT_FALSE(statistician.updateWith(1000., time_point(2s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 7.25);
+  ASSERT_EQ(statistician.getLastTimestamp(), time_point(3s));
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 4);
+}
+
+TEST(TimeDecayedStatistics, SameTimestamps) {
+  using namespace std::chrono_literals;
+  using time_point = std::chrono::steady_clock::time_point;
+
+  // Measurements at the same time weight the same
+  TimeDecayedStatistics<double> statistician(1s);
+  for (const auto sample : {2., 4., 6.})
+    ASSERT_TRUE(statistician.updateWith(sample, time_point(5s)));
+
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 3);
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 4.);
+  ASSERT_DOUBLE_EQ(statistician.getVariance(), 8. / 3.);
+
+  statistician.reset();
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 0);
+  ASSERT_TRUE(statistician.updateWith(1., time_point(0s)));
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 1.);
+  ASSERT_DOUBLE_EQ(statistician.getVariance(), 0.);
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/histogram.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(LogHistogram, BucketsAreContiguous) {
+  for (const unsigned precision : {1u, 3u, 7u}) {
+    LogHistogram histogram(1 << 20, precision);
+
+    LogHistogram::value_type expected_lower = 0;
+    for (std::size_t i = 0; i < histogram.getNumberOfBuckets(); ++i) {
+      const auto lower = histogram.lowerBoundOf(i);
+      const auto upper = histogram.upperBoundOf(i);
+      ASSERT_EQ(lower, expected_lower) << "precision = " << precision;
+      ASSERT_LT(lower, upper);
+      ASSERT_EQ(LogHistogram::indexOf(lower, precision), i);
+      ASSERT_EQ(LogHistogram::indexOf(upper - 1, precision), i);
+
+      // Above 2^P, relative width bounded by 2^(1-P)
+      if (lower >= (LogHistogram::value_type(1) << precision)) {
+        ASSERT_LE((upper - lower) << (precision - 1), lower);
+      }
+
+      expected_lower = upper;
+    }
+    ASSERT_GT(expected_lower, histogram.getMaxValue());
+  }
+}
+
+TEST(LogHistogram, Quantiles) {
+  std::mt19937 random_generator(42);
+  std::lognormal_distribution<double> distribution(10, 1);
+
+  std::vector<LogHistogram::value_type> values(100000);
+  std::generate(values.begin(), values.end(),
+                [&distribution, &random_generator]() {
+                  return static_cast<LogHistogram::value_type>(
+                      distribution(random_generator));
+                });
+
+  LogHistogram histogram;
+  for (const auto &value : values)
+    histogram.record(value);
+
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(histogram.getNumberOfMeasurements(), values.size());
+  ASSERT_EQ(histogram.getMin(), values.front());
+  ASSERT_EQ(histogram.getMax(), values.back());
+  ASSERT_EQ(histogram.quantile(0.), values.front());
+  ASSERT_EQ(histogram.quantile(1.), values.back());
+
+  for (const auto q : {0.01, 0.5, 0.9, 0.99, 0.999}) {
+    const auto exact = static_cast<double>(
+        values[static_cast<std::size_t>(std::ceil(q * values.size())) - 1]);
+    ASSERT_NEAR(histogram.quantile(q) / exact, 1., 1. / 64) << "q = " << q;
+  }
+
+  LogHistogram::count_type total = 0;
+  LogHistogram::value_type previous_upper = 0;
+  histogram.forEachBucket([&](auto lower, auto upper, auto count) {
+    ASSERT_GE(lower, previous_upper);
+    previous_upper = upper;
+    total += count;
+  });
+  ASSERT_EQ(total, values.size());
+
+  histogram.reset();
+  ASSERT_EQ(histogram.getNumberOfMeasurements(), 0);
+}
+
+TEST(LogHistogram, Merge) {
+  LogHistogram lhs, rhs, both;
+  for (LogHistogram::value_type value = 0; value < 10000; ++value) {
+    (value % 2 == 0 ? lhs : rhs).record(value * 37);
+    both.record(value * 37);
+  }
+
+  lhs.merge(rhs);
+  ASSERT_EQ(lhs.getNumberOfMeasurements(), both.getNumberOfMeasurements());
+  ASSERT_EQ(lhs.getMin(), both.getMin());
+  ASSERT_EQ(lhs.getMax(), both.getMax());
+  for (const auto q : {0.1, 0.5, 0.99})
+    ASSERT_EQ(lhs.quantile(q), both.quantile(q));
+}
+
+TEST(LogHistogram, OutOfRange) {
+  LogHistogram histogram(1000, 4);
+  histogram.record(5000, 3);
+
+  ASSERT_EQ(histogram.getNumberOfMeasurements(), 3);
+  ASSERT_EQ(histogram.getMax(), 5000);
+  ASSERT_EQ(histogram.quantile(0.5), 5000);
+}
+
+TEST(LogHistogram, InvalidPrecision) {
+  ASSERT_THROW(LogHistogram(1000, 0), std::invalid_argument);
+  ASSERT_THROW(LogHistogram(1000, 33), std::invalid_argument);
+  ASSERT_NO_THROW(LogHistogram(1000, 1));
+  ASSERT_NO_THROW(LogHistogram(1000, 32));
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
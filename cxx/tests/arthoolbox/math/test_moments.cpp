@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/moments.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+struct Moments : public ::testing::Test {
+  static void SetUpTestSuite() {
+    std::mt19937 random_generator(42);
+    std::exponential_distribution<double> distribution(0.5);
+
+    samples.resize(10000);
+    std::generate(samples.begin(), samples.end(),
+                  [&distribution, &random_generator]() {
+                    return 1000. + distribution(random_generator);
+                  });
+
+    // Reference: two passes
+    for (const auto &sample : samples)
+      mean += sample / samples.size();
+
+    double m2 = 0, m3 = 0, m4 = 0;
+    for (const auto &sample : samples) {
+      m2 += std::pow(sample - mean, 2);
+      m3 += std::pow(sample - mean, 3);
+      m4 += std::pow(sample - mean, 4);
+    }
+
+    const double n = samples.size();
+    variance = m2 / n;
+    skewness = std::sqrt(n) * m3 / std::pow(m2, 1.5);
+    kurtosis = n * m4 / (m2 * m2);
+  }
+
+  static std::vector<double> samples;
+  static double mean, variance, skewness, kurtosis;
+};
+
+std::vector<double> Moments::samples;
+double Moments::mean = 0;
+double Moments::variance = 0;
+double Moments::skewness = 0;
+double Moments::kurtosis = 0;
+
+TEST_F(Moments, RecurrentMoments) {
+  RecurrentMoments<double> statistician;
+  for (const auto &sample : samples)
+    statistician.updateWith(sample);
+
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), samples.size());
+  ASSERT_NEAR(statistician.getMean(), mean, 1e-9);
+  ASSERT_NEAR(statistician.getVariance(), variance, 1e-9);
+  ASSERT_NEAR(statistician.getSkewness(), skewness, 1e-9);
+  ASSERT_NEAR(statistician.getKurtosis(), kurtosis, 1e-9);
+  ASSERT_NEAR(statistician.getExcessKurtosis(), kurtosis - 3, 1e-9);
+
+  // Exponential distribution: skewness = 2, excess kurtosis = 6
+  ASSERT_NEAR(statistician.getSkewness(), 2, 0.2);
+  ASSERT_NEAR(statistician.getExcessKurtosis(), 6, 1.5);
+
+  statistician.reset();
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 0);
+}
+
+TEST_F(Moments, RecurrentMomentsMerge) {
+  RecurrentMoments<double> merged;
+  for (const std::size_t split : {0, 17, 4000, 9999}) {
+    RecurrentMoments<double> lhs, rhs;
+    for (std::size_t i = 0; i < samples.size(); ++i)
+      (i < split ? lhs : rhs).updateWith(samples[i]);
+
+    merged = lhs;
+    merged.merge(rhs);
+    ASSERT_EQ(merged.getNumberOfMeasurements(), samples.size());
+    ASSERT_NEAR(merged.getMean(), mean, 1e-9);
+    ASSERT_NEAR(merged.getVariance(), variance, 1e-9);
+    ASSERT_NEAR(merged.getSkewness(), skewness, 1e-9);
+    ASSERT_NEAR(merged.getKurtosis(), kurtosis, 1e-9);
+  }
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/quantile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+struct Quantile : public ::testing::Test {
+  static void SetUpTestSuite() {
+    std::mt19937 random_generator(42);
+    std::exponential_distribution<double> distribution(1.);
+
+    samples.resize(100000);
+    std::generate(samples.begin(), samples.end(),
+                  [&distribution, &random_generator]() {
+                    return distribution(random_generator);
+                  });
+
+    sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+  }
+
+  static double exact(double q) {
+    return sorted[static_cast<std::size_t>(q * (sorted.size() - 1))];
+  }
+
+  static std::vector<double> samples;
+  static std::vector<double> sorted;
+};
+
+std::vector<double> Quantile::samples;
+std::vector<double> Quantile::sorted;
+
+TEST_F(Quantile, TDigest) {
+  TDigest<double> digest(200);
+  for (const auto &sample : samples)
+    digest.updateWith(sample);
+
+  ASSERT_EQ(digest.getNumberOfMeasurements(), samples.size());
+  ASSERT_LE(digest.getNumberOfCentroids(), 2 * digest.getCompression());
+  ASSERT_EQ(digest.getMin(), sorted.front());
+  ASSERT_EQ(digest.getMax(), sorted.back());
+  ASSERT_EQ(digest.quantile(0.), sorted.front());
+  ASSERT_EQ(digest.quantile(1.), sorted.back());
+
+  // Relative error
+  for (const auto q : {0.01, 0.1, 0.5, 0.9, 0.99, 0.999})
+    ASSERT_NEAR(digest.quantile(q) / exact(q), 1., 0.02) << "q = " << q;
+
+  digest.reset();
+  ASSERT_EQ(digest.getNumberOfMeasurements(), 0);
+}
+
+TEST_F(Quantile, TDigestMerge) {
+  constexpr std::size_t parts = 7;
+
+  TDigest<double> merged(200);
+  for (std::size_t part = 0; part < parts; ++part) {
+    TDigest<double> digest(200);
+    for (std::size_t i = part; i < samples.size(); i += parts)
+      digest.updateWith(samples[i]);
+    merged.merge(digest);
+  }
+
+  ASSERT_EQ(merged.getNumberOfMeasurements(), samples.size());
+  ASSERT_EQ(merged.getMin(), sorted.front());
+  ASSERT_EQ(merged.getMax(), sorted.back());
+  for (const auto q : {0.01, 0.1, 0.5, 0.9, 0.99, 0.999})
+    ASSERT_NEAR(merged.quantile(q) / exact(q), 1., 0.02) << "q = " << q;
+}
+
+TEST(TDigest, BoundedOnLongStreams) {
+  std::mt19937 random_generator(42);
+  std::uniform_real_distribution<double> distribution(0., 1.);
+
+  TDigest<double> digest(100);
+  for (std::size_t i = 0; i < 10000000; ++i)
+    digest.updateWith(distribution(random_generator));
+
+  // The right tail keeps merging: the number of centroids stays bounded
+  ASSERT_LE(digest.getNumberOfCentroids(), 2 * digest.getCompression());
+
+  // Error relative to the size of the tail (q or 1 - q), the resolution of
+  // the k1 scale decreasing in the last per mille
+  for (const auto &[q, tolerance] : {std::pair{0.001, 0.25},
+                                     {0.01, 0.05},
+                                     {0.5, 0.01},
+                                     {0.99, 0.05},
+                                     {0.999, 0.25}})
+    ASSERT_NEAR(digest.quantile(q), q, tolerance * std::min(q, 1. - q))
+        << "q = " << q;
+}
+
+TEST_F(Quantile, TDigestFormat) {
+  TDigest<double> digest;
+  ASSERT_EQ(format(digest), "Quantiles [N = 0] -> Not enough samples yet");
+
+  digest.updateWith(42.);
+  ASSERT_EQ(digest.quantile(0.5), 42.);
+  ASSERT_EQ(format(digest), "Quantiles [N = 1]\nMin : 42\np50 : 42\n"
+                            "p90 : 42\np99 : 42\np999: 42\nMax : 42");
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/regression.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(RecurrentRegression, ExactLine) {
+  RecurrentRegression<double> regression;
+  ASSERT_EQ(0u, regression.getNumberOfMeasurements());
+
+  for (int x = 0; x < 10; ++x)
+    regression.updateWith(x, 3. * x - 2.);
+
+  ASSERT_EQ(10u, regression.getNumberOfMeasurements());
+  ASSERT_DOUBLE_EQ(4.5, regression.getMeanX());
+  ASSERT_DOUBLE_EQ(11.5, regression.getMeanY());
+  ASSERT_DOUBLE_EQ(8.25, regression.getVarianceX());
+  ASSERT_DOUBLE_EQ(9. * 8.25, regression.getVarianceY());
+  ASSERT_DOUBLE_EQ(3. * 8.25, regression.getCovariance());
+  ASSERT_DOUBLE_EQ(3., regression.getSlope());
+  ASSERT_NEAR(-2., regression.getIntercept(), 1e-12);
+  ASSERT_DOUBLE_EQ(1., regression.getCorrelation());
+
+  regression.reset();
+  ASSERT_EQ(0u, regression.getNumberOfMeasurements());
+
+  // Decreasing trend
+  for (int x = 0; x < 10; ++x)
+    regression.updateWith(x, 5. - 0.5 * x);
+  ASSERT_DOUBLE_EQ(-0.5, regression.getSlope());
+  ASSERT_DOUBLE_EQ(5., regression.getIntercept());
+  ASSERT_DOUBLE_EQ(-1., regression.getCorrelation());
+}
+
+TEST(RecurrentRegression, NoisyLineAndMerge) {
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> noise(0, 10);
+
+  std::vector<std::pair<double, double>> samples;
+  for (int i = 0; i < 5000; ++i) {
+    const double x = 1e6 + i;
+    samples.emplace_back(x, 0.25 * x + 1000. + noise(random_generator));
+  }
+
+  // Two passes reference
+  double mean_x = 0, mean_y = 0;
+  for (const auto &sample : samples) {
+    mean_x += sample.first / samples.size();
+    mean_y += sample.second / samples.size();
+  }
+  double sxx = 0, syy = 0, cxy = 0;
+  for (const auto &sample : samples) {
+    sxx += (sample.first - mean_x) * (sample.first - mean_x);
+    syy += (sample.second - mean_y) * (sample.second - mean_y);
+    cxy += (sample.first - mean_x) * (sample.second - mean_y);
+  }
+  const double slope = cxy / sxx;
+  const double intercept = mean_y - slope * mean_x;
+  const double correlation = cxy / std::sqrt(sxx * syy);
+
+  RecurrentRegression<double> regression;
+  std::vector<RecurrentRegression<double>> partials(4);
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    regression.updateWith(samples[i].first, samples[i].second);
+    partials[i % partials.size()].updateWith(samples[i].first,
+                                             samples[i].second);
+  }
+
+  RecurrentRegression<double> merged;
+  for (const auto &partial : partials)
+    merged.merge(partial);
+
+  for (const auto &stats : {regression, merged}) {
+    ASSERT_EQ(samples.size(), stats.getNumberOfMeasurements());
+    ASSERT_NEAR(slope, stats.getSlope(), 1e-9);
+    ASSERT_NEAR(intercept, stats.getIntercept(), 1e-3);
+    ASSERT_NEAR(correlation, stats.getCorrelation(), 1e-9);
+  }
+  ASSERT_NEAR(0.25, regression.getSlope(), 1e-2);
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
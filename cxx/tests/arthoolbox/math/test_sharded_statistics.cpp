@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/sharded_statistics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(ShardedStatistics, SingleThread) {
+  ShardedStatistics<double> sharded(4);
+  RecurrentStatistics<double, double> reference;
+
+  ASSERT_EQ(sharded.getNumberOfShards(), 4);
+  ASSERT_EQ(sharded.snapshot().getNumberOfMeasurements(), 0);
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    sharded.updateWith(i * 0.5);
+    reference.updateWith(i * 0.5);
+  }
+
+  const auto snapshot = sharded.snapshot();
+  ASSERT_EQ(snapshot.getNumberOfMeasurements(), 1000);
+  ASSERT_DOUBLE_EQ(snapshot.getMean(), reference.getMean());
+  ASSERT_DOUBLE_EQ(snapshot.getVariance(), reference.getVariance());
+
+  sharded.reset();
+  ASSERT_EQ(sharded.snapshot().getNumberOfMeasurements(), 0);
+
+  // The shard is cleared on its next update
+  sharded.updateWith(1.);
+  sharded.updateWith(3.);
+  const auto after_reset = sharded.snapshot();
+  ASSERT_EQ(after_reset.getNumberOfMeasurements(), 2);
+  ASSERT_DOUBLE_EQ(after_reset.getMean(), 2.);
+  ASSERT_DOUBLE_EQ(after_reset.getVariance(), 1.);
+}
+
+TEST(ShardedStatistics, ThreadSlotsAreRecycled) {
+  const auto main_slot = details::ThreadSlots::current();
+
+  // Threads running one after the other get the same slot
+  std::vector<std::size_t> sequential;
+  for (std::size_t t = 0; t < 16; ++t)
+    std::thread([&sequential] {
+      sequential.push_back(details::ThreadSlots::current());
+    }).join();
+
+  ASSERT_NE(sequential.front(), main_slot);
+  ASSERT_TRUE(std::all_of(
+      sequential.cbegin(), sequential.cend(),
+      [&sequential](std::size_t slot) { return slot == sequential.front(); }));
+
+  // Running threads get distinct slots, < the number of running threads
+  constexpr std::size_t thread_count = 4;
+  std::vector<std::size_t> slots(thread_count);
+  std::atomic<std::size_t> ready{0};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < thread_count; ++t) {
+    threads.emplace_back([&slots, &ready, t] {
+      slots[t] = details::ThreadSlots::current();
+      ++ready;
+      while (ready.load() != thread_count)
+        ;
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  ASSERT_EQ(std::set<std::size_t>(slots.cbegin(), slots.cend()).size(),
+            thread_count);
+  for (const auto slot : slots) {
+    ASSERT_NE(slot, main_slot);
+    ASSERT_LE(slot, thread_count);
+  }
+}
+
+TEST(ShardedStatistics, ThreadChurn) {
+  constexpr std::size_t generations = 64;
+  constexpr std::size_t thread_count = 2;
+  constexpr std::size_t samples_per_thread = 1000;
+
+  // Short lived threads, never more running than shards
+  ShardedStatistics<double> sharded(thread_count + 1);
+  for (std::size_t g = 0; g < generations; ++g) {
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+      writers.emplace_back([&sharded] {
+        for (std::size_t i = 0; i < samples_per_thread; ++i)
+          sharded.updateWith(static_cast<double>(i % 10));
+      });
+    }
+    for (auto &writer : writers)
+      writer.join();
+  }
+
+  const auto snapshot = sharded.snapshot();
+  ASSERT_EQ(snapshot.getNumberOfMeasurements(),
+            generations * thread_count * samples_per_thread);
+  ASSERT_NEAR(snapshot.getMean(), 4.5, 1e-9);
+  ASSERT_NEAR(snapshot.getVariance(), 8.25, 1e-9);
+}
+
+TEST(ShardedStatistics, MultipleThreads) {
+  constexpr std::size_t thread_count = 8;
+  constexpr std::size_t samples_per_thread = 10000;
+
+  // More writers than shards: some of them share the overflow shard
+  ShardedStatistics<double> sharded(thread_count / 2);
+  std::atomic<bool> done{false};
+
+  // Concurrent reader: N is monotonic and snapshots are always consistent
+  std::thread reader([&sharded, &done] {
+    std::size_t previous = 0;
+    while (!done.load()) {
+      const auto snapshot = sharded.snapshot();
+      ASSERT_GE(snapshot.getNumberOfMeasurements(), previous);
+      previous = snapshot.getNumberOfMeasurements();
+    }
+  });
+
+  std::vector<std::thread> writers;
+  for (std::size_t t = 0; t < thread_count; ++t) {
+    writers.emplace_back([&sharded] {
+      for (std::size_t i = 0; i < samples_per_thread; ++i)
+        sharded.updateWith(static_cast<double>(i % 100));
+    });
+  }
+
+  for (auto &writer : writers)
+    writer.join();
+  done.store(true);
+  reader.join();
+
+  RecurrentStatistics<double, double> reference;
+  for (std::size_t i = 0; i < samples_per_thread; ++i)
+    reference.updateWith(static_cast<double>(i % 100));
+
+  const auto snapshot = sharded.snapshot();
+  ASSERT_EQ(snapshot.getNumberOfMeasurements(),
+            thread_count * samples_per_thread);
+  ASSERT_NEAR(snapshot.getMean(), reference.getMean(), 1e-9);
+  ASSERT_NEAR(snapshot.getVariance(), reference.getVariance(), 1e-9);
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/shared_statistics.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>    // O_* constants
+#include <sys/mman.h> // shm_open, mmap
+#include <unistd.h>   // getpid, ftruncate
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+std::string getUniqueName(const char *suffix) {
+  return "/arthoolbox_test_" + std::to_string(::getpid()) + "_" + suffix;
+}
+
+/// Create a shared memory object of size bytes, its first 64 bits word being
+/// set to sequence
+void createRegion(const std::string &name, const std::size_t size,
+                  const std::uint64_t sequence) {
+  const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+  ASSERT_NE(-1, fd);
+  ASSERT_EQ(0, ::ftruncate(fd, size));
+  void *address =
+      ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  ASSERT_NE(MAP_FAILED, address);
+  *static_cast<std::uint64_t *>(address) = sequence;
+  ::munmap(address, size);
+}
+
+TEST(SharedStatistics, PublishAndRead) {
+  StatisticsPublisher publisher(getUniqueName("publish"));
+  StatisticsSubscriber subscriber(publisher.getName());
+
+  RecurrentStatistics<double, double> read;
+  ASSERT_EQ(0u, subscriber.getNumberOfPublications());
+  ASSERT_TRUE(subscriber.read(read));
+  ASSERT_EQ(0u, read.getNumberOfMeasurements());
+
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(1.);
+  stats.updateWith(2.);
+  stats.updateWith(6.);
+  publisher.publish(stats);
+
+  ASSERT_EQ(1u, subscriber.getNumberOfPublications());
+  ASSERT_TRUE(subscriber.read(read));
+  ASSERT_EQ(stats.getNumberOfMeasurements(), read.getNumberOfMeasurements());
+  ASSERT_DOUBLE_EQ(stats.getMean(), read.getMean());
+  ASSERT_DOUBLE_EQ(stats.getVariance(), read.getVariance());
+
+  RecurrentStatistics<float, float> float_stats;
+  float_stats.updateWith(4.f);
+  publisher.publish(float_stats);
+
+  ASSERT_EQ(2u, subscriber.getNumberOfPublications());
+  ASSERT_TRUE(subscriber.read(read));
+  ASSERT_EQ(1u, read.getNumberOfMeasurements());
+  ASSERT_DOUBLE_EQ(4., read.getMean());
+}
+
+TEST(SharedStatistics, Errors) {
+  ASSERT_THROW(StatisticsSubscriber(getUniqueName("missing")),
+               std::system_error);
+
+  std::string name;
+  {
+    StatisticsPublisher publisher(getUniqueName("unlinked"));
+    name = publisher.getName();
+    ASSERT_NO_THROW(StatisticsSubscriber{name});
+  }
+  ASSERT_THROW(StatisticsSubscriber{name}, std::system_error);
+
+  // Not created by a publisher: too small to be mapped
+  const auto small = getUniqueName("small");
+  createRegion(small, sizeof(std::uint64_t), 0);
+  ASSERT_THROW(StatisticsSubscriber{small}, std::system_error);
+  ::shm_unlink(small.c_str());
+}
+
+TEST(SharedStatistics, CrashedPublisher) {
+  // Region left by a publisher that died while publishing (odd sequence)
+  const auto name = getUniqueName("crashed");
+  createRegion(name, sizeof(details::SharedStatisticsRegion), 3);
+
+  RecurrentStatistics<double, double> read;
+  read.updateWith(42.);
+  {
+    StatisticsSubscriber subscriber(name);
+    ASSERT_FALSE(subscriber.read(read));
+    ASSERT_EQ(1u, read.getNumberOfMeasurements());
+  }
+
+  // A new publisher resets the region
+  StatisticsPublisher publisher(name);
+  StatisticsSubscriber subscriber(name);
+  ASSERT_EQ(0u, subscriber.getNumberOfPublications());
+  ASSERT_TRUE(subscriber.read(read));
+  ASSERT_EQ(0u, read.getNumberOfMeasurements());
+}
+
+TEST(SharedStatistics, OnlyUnlinkOwnRegion) {
+  const auto name = getUniqueName("owner");
+  auto first = std::make_unique<StatisticsPublisher>(name);
+
+  // The name is re-used by an other publisher, the first one must not remove
+  // it when destroyed
+  ::shm_unlink(name.c_str());
+  StatisticsPublisher second(name);
+  first.reset();
+  ASSERT_NO_THROW(StatisticsSubscriber{name});
+}
+
+TEST(SharedStatistics, ConsistentSnapshots) {
+  StatisticsPublisher publisher(getUniqueName("consistent"));
+  StatisticsSubscriber subscriber(publisher.getName());
+
+  constexpr std::size_t n = 100000;
+  std::atomic<bool> done{false};
+
+  // Publishing the integers [0, N), the mean must always be (N - 1) / 2
+  std::thread writer([&]() {
+    RecurrentStatistics<double, double> stats;
+    for (std::size_t i = 0; i < n; ++i) {
+      stats.updateWith(static_cast<double>(i));
+      publisher.publish(stats);
+    }
+    done = true;
+  });
+
+  std::size_t last_n = 0;
+  RecurrentStatistics<double, double> read;
+  while (not done) {
+    if (not subscriber.read(read))
+      continue;
+    const auto read_n = read.getNumberOfMeasurements();
+    ASSERT_GE(read_n, last_n);
+    if (read_n != 0) {
+      ASSERT_DOUBLE_EQ((read_n - 1) / 2., read.getMean());
+    }
+    last_n = read_n;
+  }
+  writer.join();
+
+  ASSERT_TRUE(subscriber.read(read));
+  ASSERT_EQ(n, read.getNumberOfMeasurements());
+  ASSERT_EQ(n, subscriber.getNumberOfPublications());
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/snapshot.hpp"
+
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace snapshot {
+namespace {
+
+TEST(Snapshot, Header) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(1.);
+  stats.updateWith(2.);
+
+  std::vector<char> buffer(size(stats));
+  ASSERT_EQ(write(stats, buffer.data()), buffer.data() + buffer.size());
+
+  // Fixed little endian layout
+  ASSERT_EQ(buffer[0], 'A');
+  ASSERT_EQ(buffer[1], 'R');
+  ASSERT_EQ(buffer[2], 'T');
+  ASSERT_EQ(buffer[3], 'S');
+  ASSERT_EQ(buffer[4], version);
+  ASSERT_EQ(buffer[6], static_cast<char>(Kind::Statistics));
+  ASSERT_EQ(buffer[header_size], 2);
+
+  const View view(buffer.data(), buffer.size());
+  ASSERT_TRUE(view.isValid());
+  ASSERT_EQ(view.getKind(), Kind::Statistics);
+  ASSERT_EQ(view.getSize(), buffer.size());
+
+  // Truncated or corrupted buffers are rejected
+  ASSERT_FALSE(View(buffer.data(), buffer.size() - 1).isValid());
+  ASSERT_FALSE(View(buffer.data(), header_size - 1).isValid());
+  ASSERT_FALSE(LogHistogramView(buffer.data(), buffer.size()).isValid());
+  buffer[0] = 'X';
+  ASSERT_FALSE(View(buffer.data(), buffer.size()).isValid());
+}
+
+TEST(Snapshot, RecurrentStatistics) {
+  RecurrentStatistics<float, double> stats;
+  for (int i = 0; i < 100; ++i)
+    stats.updateWith(i * 0.25f);
+
+  std::vector<char> buffer(size(stats));
+  write(stats, buffer.data());
+
+  const StatisticsView view(buffer.data(), buffer.size());
+  ASSERT_TRUE(view.isValid());
+  ASSERT_EQ(view.getNumberOfMeasurements(), 100);
+  ASSERT_EQ(view.getMean(), stats.getMean());
+  ASSERT_EQ(view.getSumSquare(), stats.getSumSquare());
+
+  const auto deserialized = view.toStatistics<float, double>();
+  ASSERT_TRUE(deserialized.has_value());
+  const auto &copy = *deserialized;
+  ASSERT_EQ(copy.getNumberOfMeasurements(), stats.getNumberOfMeasurements());
+  ASSERT_EQ(copy.getMean(), stats.getMean());
+  ASSERT_EQ(copy.getVariance(), stats.getVariance());
+
+  // Non finite or negative values are rejected
+  for (const auto &[offset, value] :
+       {std::pair{8, std::numeric_limits<double>::quiet_NaN()},
+        {8, std::numeric_limits<double>::infinity()},
+        {16, -1.},
+        {16, std::numeric_limits<double>::quiet_NaN()}}) {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + header_size + offset, value);
+    const StatisticsView corrupted_view(corrupted.data(), corrupted.size());
+    ASSERT_FALSE(corrupted_view.isValid());
+    ASSERT_FALSE(corrupted_view.toStatistics<double>().has_value());
+  }
+}
+
+TEST(Snapshot, LogHistogram) {
+  std::mt19937 random_generator(42);
+  std::lognormal_distribution<double> distribution(10, 1);
+
+  LogHistogram histogram(1 << 30, 5);
+  for (int i = 0; i < 10000; ++i)
+    histogram.record(
+        static_cast<LogHistogram::value_type>(distribution(random_generator)));
+
+  std::vector<char> buffer(size(histogram));
+  ASSERT_EQ(write(histogram, buffer.data()), buffer.data() + buffer.size());
+
+  const LogHistogramView view(buffer.data(), buffer.size());
+  ASSERT_TRUE(view.isValid());
+  ASSERT_EQ(view.getNumberOfBuckets(), histogram.getNumberOfBuckets());
+
+  const auto deserialized = view.toHistogram();
+  ASSERT_TRUE(deserialized.has_value());
+  const auto &copy = *deserialized;
+  ASSERT_EQ(copy.getNumberOfMeasurements(),
+            histogram.getNumberOfMeasurements());
+  ASSERT_EQ(copy.getMin(), histogram.getMin());
+  ASSERT_EQ(copy.getMax(), histogram.getMax());
+  for (const auto q : {0.1, 0.5, 0.99})
+    ASSERT_EQ(copy.quantile(q), histogram.quantile(q));
+
+  // Zero copy aggregation
+  LogHistogram aggregated(1 << 30, 5);
+  ASSERT_TRUE(view.mergeInto(aggregated));
+  ASSERT_TRUE(view.mergeInto(aggregated));
+  ASSERT_EQ(aggregated.getNumberOfMeasurements(),
+            2 * histogram.getNumberOfMeasurements());
+  ASSERT_EQ(aggregated.quantile(0.5), histogram.quantile(0.5));
+
+  LogHistogram other_configuration(1 << 30, 6);
+  ASSERT_FALSE(view.mergeInto(other_configuration));
+  ASSERT_EQ(other_configuration.getNumberOfMeasurements(), 0);
+}
+
+TEST(Snapshot, LogHistogramCorrupted) {
+  LogHistogram histogram(1 << 20, 4);
+  histogram.record(42);
+
+  std::vector<char> buffer(size(histogram));
+  write(histogram, buffer.data());
+  ASSERT_TRUE(LogHistogramView(buffer.data(), buffer.size()).isValid());
+
+  // Precision outside of [1, 32]
+  for (const std::uint32_t precision : {0u, 33u, 0xFFFFFFFFu}) {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + header_size, precision);
+    const LogHistogramView view(corrupted.data(), corrupted.size());
+    ASSERT_FALSE(view.isValid());
+    ASSERT_FALSE(view.toHistogram().has_value());
+  }
+
+  // Max value not matching the number of buckets (e.g. needing way more)
+  for (const auto max_value :
+       {std::uint64_t(1) << 21, std::numeric_limits<std::uint64_t>::max()}) {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + header_size + 8, max_value);
+    const LogHistogramView view(corrupted.data(), corrupted.size());
+    ASSERT_FALSE(view.isValid());
+    ASSERT_FALSE(view.toHistogram().has_value());
+  }
+}
+
+TEST(Snapshot, TDigest) {
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(0, 1);
+
+  TDigest<double> digest(100);
+  for (int i = 0; i < 10000; ++i)
+    digest.updateWith(distribution(random_generator));
+
+  std::vector<char> buffer(size(digest));
+  ASSERT_EQ(write(digest, buffer.data()), buffer.data() + buffer.size());
+
+  const TDigestView view(buffer.data(), buffer.size());
+  ASSERT_TRUE(view.isValid());
+  ASSERT_EQ(view.getCompression(), digest.getCompression());
+  ASSERT_EQ(view.getNumberOfCentroids(), digest.getNumberOfCentroids());
+
+  const auto deserialized = view.toTDigest();
+  ASSERT_TRUE(deserialized.has_value());
+  const auto &copy = *deserialized;
+  ASSERT_EQ(copy.getNumberOfMeasurements(), digest.getNumberOfMeasurements());
+  ASSERT_EQ(copy.getMin(), digest.getMin());
+  ASSERT_EQ(copy.getMax(), digest.getMax());
+  for (const auto q : {0.01, 0.5, 0.99})
+    ASSERT_NEAR(copy.quantile(q), digest.quantile(q), 1e-9);
+}
+
+TEST(Snapshot, TDigestCorrupted) {
+  TDigest<double> digest(100);
+  for (int i = 0; i < 1000; ++i)
+    digest.updateWith(i);
+
+  std::vector<char> buffer(size(digest));
+  write(digest, buffer.data());
+  ASSERT_TRUE(TDigestView(buffer.data(), buffer.size()).isValid());
+
+  const auto check_rejected = [](const std::vector<char> &corrupted) {
+    const TDigestView view(corrupted.data(), corrupted.size());
+    ASSERT_FALSE(view.isValid());
+    ASSERT_FALSE(view.toTDigest().has_value());
+
+    TDigest<double> other;
+    ASSERT_FALSE(view.mergeInto(other));
+    ASSERT_EQ(other.getNumberOfMeasurements(), 0);
+  };
+
+  // Compression out of bound (e.g. huge allocation), or too small for the
+  // number of centroids (10)
+  for (const std::uint32_t compression :
+       {0u, 10u, std::uint32_t(max_tdigest_compression + 1), 0xFFFFFFFFu}) {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + header_size, compression);
+    check_rejected(corrupted);
+  }
+
+  // Non finite or non positive weights
+  const std::size_t first_weight = header_size + 32 + 8;
+  for (const auto weight : {0., -1., std::numeric_limits<double>::quiet_NaN(),
+                            std::numeric_limits<double>::infinity()}) {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + first_weight, weight);
+    check_rejected(corrupted);
+  }
+
+  // Non finite mean
+  {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + first_weight - 8,
+                   std::numeric_limits<double>::quiet_NaN());
+    check_rejected(corrupted);
+  }
+
+  // Weights not summing up to N
+  {
+    auto corrupted = buffer;
+    details::store(corrupted.data() + header_size + 8, std::uint64_t(999));
+    check_rejected(corrupted);
+  }
+}
+
+} // namespace
+} // namespace snapshot
+} // namespace stats
+} // namespace arthoolbox
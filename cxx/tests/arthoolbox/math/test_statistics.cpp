@@ -4,11 +4,16 @@
 #include "arthoolbox/math/statistics.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <iterator>
+#include <list>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace arthoolbox {
 namespace stats {
@@ -99,6 +104,295 @@ TEST_F(Statistics, RecurringStatistics) {
   ASSERT_EQ(statistician.getMean(), 0);
 }
 
+TEST_F(Statistics, RecurringStatisticsBatchUpdate) {
+  RecurrentStatistics<data_type, double> statistician;
+  statistician.updateWith(data.samples.cbegin(), data.samples.cend());
+
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(statistician.getMean(), data.mean, 1e-6);
+  ASSERT_NEAR(statistician.getVariance(), data.variance, 1e-6);
+
+  // Non random access iterators fall back to the per-sample update
+  std::list<data_type> samples(data.samples.cbegin(), data.samples.cend());
+  RecurrentStatistics<data_type, double> from_list;
+  from_list.updateWith(samples.cbegin(), samples.cend());
+
+  ASSERT_EQ(from_list.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(from_list.getMean(), data.mean, 1e-6);
+  ASSERT_NEAR(from_list.getVariance(), data.variance, 1e-6);
+
+  // Mixing both updates
+  RecurrentStatistics<data_type, double> mixed;
+  const auto middle = std::next(data.samples.cbegin(), 1001);
+  for (auto it = data.samples.cbegin(); it != middle; ++it)
+    mixed.updateWith(*it);
+  mixed.updateWith(middle, data.samples.cend());
+
+  ASSERT_EQ(mixed.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(mixed.getMean(), data.mean, 1e-6);
+  ASSERT_NEAR(mixed.getVariance(), data.variance, 1e-6);
+}
+
+TEST_F(Statistics, RecurringStatisticsMerge) {
+  const auto middle = std::next(data.samples.cbegin(), 1234);
+
+  RecurrentStatistics<data_type, double> lhs;
+  for (auto it = data.samples.cbegin(); it != middle; ++it)
+    lhs.updateWith(*it);
+
+  RecurrentStatistics<data_type, double> rhs;
+  for (auto it = middle; it != data.samples.cend(); ++it)
+    rhs.updateWith(*it);
+
+  lhs.merge(rhs);
+  ASSERT_EQ(lhs.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(lhs.getMean(), data.mean, 1e-6);
+  ASSERT_NEAR(lhs.getVariance(), data.variance, 1e-6);
+
+  // Merging empty stats is a no-op, merging into empty stats is a copy
+  RecurrentStatistics<data_type, double> empty;
+  lhs.merge(empty);
+  ASSERT_EQ(lhs.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(lhs.getMean(), data.mean, 1e-6);
+
+  empty.merge(lhs);
+  ASSERT_EQ(empty.getNumberOfMeasurements(), lhs.getNumberOfMeasurements());
+  ASSERT_EQ(empty.getMean(), lhs.getMean());
+  ASSERT_EQ(empty.getSumSquare(), lhs.getSumSquare());
+}
+
+TEST_F(Statistics, ComputeStatistics) {
+  const auto seq = compute_statistics(execution::seq, data.samples.cbegin(),
+                                      data.samples.cend());
+  ASSERT_EQ(seq.getNumberOfMeasurements(), data.samples.size());
+  ASSERT_NEAR(seq.getMean(), data.mean, 1e-6);
+  ASSERT_NEAR(seq.getVariance(), data.variance, 1e-6);
+
+  // Big enough to be split across multiple threads
+  std::vector<data_type> samples;
+  while (samples.size() < (1 << 17))
+    samples.insert(samples.end(), data.samples.cbegin(), data.samples.cend());
+
+  const auto reference = compute_statistics(execution::seq, samples.cbegin(),
+                                            samples.cend());
+
+  execution::parallel_policy policy;
+  for (policy.thread_count = 1; policy.thread_count < 8;
+       ++policy.thread_count) {
+    const auto par =
+        compute_statistics(policy, samples.cbegin(), samples.cend());
+    ASSERT_EQ(par.getNumberOfMeasurements(), samples.size());
+    ASSERT_NEAR(par.getMean(), reference.getMean(), 1e-9);
+    ASSERT_NEAR(par.getVariance(), reference.getVariance(), 1e-9);
+  }
+}
+
+TEST(CompensatedSum, Summation) {
+  // Terms close to the float epsilon are (partially) lost by a naive sum
+  constexpr std::size_t n = 100000;
+  constexpr float term = 1e-5f;
+
+  float naive = 1.f;
+  CompensatedSum<float> compensated = 1.f;
+  for (std::size_t i = 0; i < n; ++i) {
+    naive += term;
+    compensated += term;
+  }
+
+  const double expected = 1. + n * static_cast<double>(term);
+  ASSERT_GT(std::abs(naive - expected), 1e-3);
+  ASSERT_NEAR(static_cast<float>(compensated), expected, 1e-6);
+}
+
+TEST(CompensatedSum, RecurringStatistics) {
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(42, 5e-3);
+
+  std::vector<float> samples(1 << 20);
+  std::generate(samples.begin(), samples.end(),
+                [&distribution, &random_generator]() {
+                  return static_cast<float>(distribution(random_generator));
+                });
+
+  RecurrentStatistics<double, double> reference;
+  RecurrentStatistics<float, float> naive;
+  RecurrentStatistics<float, CompensatedSum<float>> compensated;
+  RecurrentStatistics<float, CompensatedSum<float>> compensated_batch;
+
+  for (const auto &sample : samples) {
+    reference.updateWith(sample);
+    naive.updateWith(sample);
+    compensated.updateWith(sample);
+  }
+  compensated_batch.updateWith(samples.cbegin(), samples.cend());
+
+  const auto naive_error =
+      std::abs(naive.getVariance() - reference.getVariance());
+  const auto compensated_error =
+      std::abs(compensated.getVariance() - reference.getVariance());
+
+  ASSERT_LT(compensated_error * 10, naive_error);
+  ASSERT_NEAR(compensated.getMean(), reference.getMean(), 1e-6);
+  ASSERT_NEAR(compensated.getVariance(), reference.getVariance(),
+              reference.getVariance() * 1e-3);
+  ASSERT_NEAR(compensated_batch.getMean(), reference.getMean(), 1e-6);
+  ASSERT_NEAR(compensated_batch.getVariance(), reference.getVariance(),
+              reference.getVariance() * 1e-3);
+
+  ASSERT_FALSE(format(compensated).empty());
+}
+
+TEST(RecurrentStatistics, Format) {
+  RecurrentStatistics<double, double> stats;
+  ASSERT_EQ(format(stats), "Stats [N = 0]\nMean: 0"
+                           "\nVar :  -> Not enough samples yet"
+                           "\nSVar:  -> Not enough samples yet");
+  ASSERT_EQ(format(stats, FormatStyle::Compact), "N=0 mean=0 var=- svar=-");
+
+  stats.updateWith(1.5);
+  ASSERT_EQ(format(stats, FormatStyle::Compact), "N=1 mean=1.5 var=0 svar=-");
+
+  stats.reset(0., 0.);
+  stats.updateWith(1.);
+  stats.updateWith(2.);
+  stats.updateWith(6.);
+  ASSERT_EQ(format(stats), "Stats [N = 3]\nMean: 3"
+                           "\nVar : 4.66667"
+                           "\nSVar: 7");
+  ASSERT_EQ(format(stats, FormatStyle::Compact),
+            "N=3 mean=3 var=4.66667 svar=7");
+
+  // Same output as the std::ostream default formatting
+  stats.reset(0., 0.);
+  for (const auto sample : {1e-7, 123456789., -0.5})
+    stats.updateWith(sample);
+  std::stringstream expected;
+  expected << "Stats [N = 3]\nMean: " << stats.getMean()
+           << "\nVar : " << stats.getVariance()
+           << "\nSVar: " << stats.getSampledVariance();
+  ASSERT_EQ(format(stats), expected.str());
+
+  RecurrentStatistics<float, CompensatedSum<float>> compensated;
+  compensated.updateWith(0.5f);
+  compensated.updateWith(1.5f);
+  ASSERT_EQ(format(compensated, FormatStyle::Compact),
+            "N=2 mean=1 var=0.25 svar=0.5");
+}
+
+/// Non arithmetic mean type, only printable with operator<<
+struct Meters {
+  Meters(double v = 0.) : value(v) {}
+  operator double() const { return value; }
+
+  friend std::ostream &operator<<(std::ostream &os, const Meters &m) {
+    return os << m.value << " m";
+  }
+
+  double value;
+};
+
+TEST(RecurrentStatistics, FormatStream) {
+  RecurrentStatistics<double, Meters> stats;
+  ASSERT_EQ(format(stats), "Stats [N = 0]\nMean: 0 m"
+                           "\nVar :  -> Not enough samples yet"
+                           "\nSVar:  -> Not enough samples yet");
+
+  stats.updateWith(1.);
+  stats.updateWith(3.);
+  ASSERT_EQ(format(stats), "Stats [N = 2]\nMean: 2 m\nVar : 1 m\nSVar: 2 m");
+  ASSERT_EQ(format(stats, FormatStyle::Compact),
+            "N=2 mean=2 m var=1 m svar=2 m");
+}
+
+TEST(RecurrentStatistics, FormatTo) {
+  RecurrentStatistics<double, double> stats;
+  stats.updateWith(1.);
+  stats.updateWith(3.);
+
+  const std::string expected = "N=2 mean=2 var=1 svar=2";
+
+  char buffer[64];
+  auto result =
+      format_to_n(buffer, sizeof(buffer), stats, FormatStyle::Compact);
+  ASSERT_EQ(expected.size(), result.size);
+  ASSERT_EQ(buffer + expected.size(), result.out);
+  ASSERT_EQ(expected, std::string(buffer, result.out));
+
+  // Truncated output still reports the full size
+  result = format_to_n(buffer, 5, stats, FormatStyle::Compact);
+  ASSERT_EQ(expected.size(), result.size);
+  ASSERT_EQ(buffer + 5, result.out);
+  ASSERT_EQ(expected.substr(0, 5), std::string(buffer, result.out));
+
+  std::string text;
+  format_to(std::back_inserter(text), stats);
+  ASSERT_EQ(format(stats), text);
+}
+
+TEST(IntegerStatistics, Exact) {
+  IntegerStatistics<int> stats;
+  ASSERT_EQ(0u, stats.getNumberOfMeasurements());
+  ASSERT_EQ(0., stats.getMean());
+
+  for (const int sample : {7, 3, 2, 8})
+    stats.updateWith(sample);
+
+  ASSERT_EQ(4u, stats.getNumberOfMeasurements());
+  ASSERT_EQ(7, stats.getOffset());
+  ASSERT_EQ(-8, stats.getShiftedSum());
+  ASSERT_EQ(42u, stats.getShiftedSumSquare());
+  ASSERT_DOUBLE_EQ(5., stats.getMean());
+  ASSERT_DOUBLE_EQ(6.5, stats.getVariance());
+  ASSERT_DOUBLE_EQ(26. / 3., stats.getSampledVariance());
+
+  stats.reset();
+  ASSERT_EQ(0u, stats.getNumberOfMeasurements());
+  ASSERT_EQ(0, stats.getShiftedSum());
+}
+
+TEST(IntegerStatistics, Timestamps) {
+  // Nanoseconds timestamps: the squares don't even fit into 64 bits
+  constexpr std::int64_t start = 1700000000000000000;
+  std::mt19937 random_generator(42);
+  std::uniform_int_distribution<std::int64_t> jitter(-1000, 1000);
+
+  IntegerStatistics<std::int64_t> stats;
+  IntegerStatistics<std::int64_t> lhs, rhs;
+  std::vector<std::int64_t> samples;
+  for (std::int64_t i = 0; i < 10000; ++i) {
+    samples.push_back(start + i * 1000000 + jitter(random_generator));
+    stats.updateWith(samples.back());
+    (i < 3000 ? lhs : rhs).updateWith(samples.back());
+  }
+
+  // Exact reference, computed relative to the start
+  long double mean = 0;
+  for (const auto sample : samples)
+    mean += sample - start;
+  mean /= samples.size();
+  long double variance = 0;
+  for (const auto sample : samples)
+    variance += (sample - start - mean) * (sample - start - mean);
+  variance /= samples.size();
+
+  ASSERT_NEAR(static_cast<double>(start + mean), stats.getMean(), 1.);
+  ASSERT_NEAR(static_cast<double>(variance), stats.getVariance(),
+              static_cast<double>(variance) * 1e-12);
+
+  lhs.merge(rhs);
+  ASSERT_EQ(stats.getNumberOfMeasurements(), lhs.getNumberOfMeasurements());
+  ASSERT_EQ(stats.getOffset(), lhs.getOffset());
+  ASSERT_TRUE(stats.getShiftedSum() == lhs.getShiftedSum());
+  ASSERT_TRUE(stats.getShiftedSumSquare() == lhs.getShiftedSumSquare());
+
+  // Merging with empty statistics
+  IntegerStatistics<std::int64_t> empty;
+  empty.merge(rhs);
+  ASSERT_EQ(rhs.getOffset(), empty.getOffset());
+  rhs.merge(IntegerStatistics<std::int64_t>());
+  ASSERT_EQ(7000u, rhs.getNumberOfMeasurements());
+}
+
 } // namespace
 } // namespace stats
 } // namespace arthoolbox
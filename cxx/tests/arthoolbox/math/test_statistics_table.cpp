@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/statistics_table.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+TEST(StatisticsTable, Record) {
+  StatisticsTable<std::string> table;
+  ASSERT_EQ(0u, table.size());
+  ASSERT_EQ(0u, table.getCapacity());
+  ASSERT_EQ(0u, table.getStatistics("foo").getNumberOfMeasurements());
+
+  table.record("foo", 1.);
+  table.record("bar", 10.);
+  table.record("foo", 3.);
+
+  ASSERT_EQ(2u, table.size());
+  const auto foo = table.getStatistics("foo");
+  ASSERT_EQ(2u, foo.getNumberOfMeasurements());
+  ASSERT_DOUBLE_EQ(2., foo.getMean());
+  ASSERT_DOUBLE_EQ(1., foo.getVariance());
+  ASSERT_EQ(1u, table.getStatistics("bar").getNumberOfMeasurements());
+  ASSERT_EQ(0u, table.getStatistics("baz").getNumberOfMeasurements());
+
+  std::size_t keys = 0;
+  table.forEach([&keys](const std::string &, const auto &stats) {
+    ++keys;
+    ASSERT_NE(0u, stats.getNumberOfMeasurements());
+  });
+  ASSERT_EQ(2u, keys);
+
+  const auto capacity = table.getCapacity();
+  table.clear();
+  ASSERT_EQ(0u, table.size());
+  ASSERT_EQ(capacity, table.getCapacity());
+  ASSERT_EQ(0u, table.getStatistics("foo").getNumberOfMeasurements());
+}
+
+TEST(StatisticsTable, BatchAndSnapshot) {
+  constexpr std::size_t number_of_keys = 50000;
+  std::mt19937 random_generator(42);
+  std::uniform_int_distribution<std::uint32_t> key_distribution(
+      0, number_of_keys - 1);
+  std::normal_distribution<double> value_distribution(100, 10);
+
+  std::vector<std::uint32_t> keys(200000);
+  std::vector<double> values(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = key_distribution(random_generator) * 64; // Colliding low bits
+    values[i] = value_distribution(random_generator);
+  }
+
+  std::unordered_map<std::uint32_t, RecurrentStatistics<double, double>>
+      reference;
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    reference[keys[i]].updateWith(values[i]);
+
+  StatisticsTable<std::uint32_t> table;
+  table.record(keys.data(), values.data(), keys.size() / 2);
+  for (std::size_t i = keys.size() / 2; i < keys.size(); ++i)
+    table.record(keys[i], values[i]);
+
+  ASSERT_EQ(reference.size(), table.size());
+  ASSERT_LE(2 * table.size(), table.getCapacity());
+  for (const auto &expected : reference) {
+    const auto stats = table.getStatistics(expected.first);
+    ASSERT_EQ(expected.second.getNumberOfMeasurements(),
+              stats.getNumberOfMeasurements());
+    ASSERT_DOUBLE_EQ(expected.second.getMean(), stats.getMean());
+    ASSERT_DOUBLE_EQ(expected.second.getSumSquare(), stats.getSumSquare());
+  }
+
+  auto sequential = table.snapshot(execution::seq);
+  auto parallel = table.snapshot(execution::parallel_policy{4});
+  ASSERT_EQ(table.size(), sequential.size());
+  ASSERT_EQ(table.size(), parallel.size());
+
+  const auto by_key = [](const auto &lhs, const auto &rhs) {
+    return lhs.first < rhs.first;
+  };
+  std::sort(sequential.begin(), sequential.end(), by_key);
+  std::sort(parallel.begin(), parallel.end(), by_key);
+  for (std::size_t i = 0; i < sequential.size(); ++i) {
+    ASSERT_EQ(sequential[i].first, parallel[i].first);
+    ASSERT_EQ(sequential[i].second.getNumberOfMeasurements(),
+              parallel[i].second.getNumberOfMeasurements());
+    ASSERT_EQ(reference[sequential[i].first].getMean(),
+              sequential[i].second.getMean());
+  }
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
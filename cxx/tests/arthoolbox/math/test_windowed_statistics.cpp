@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "arthoolbox/math/windowed_statistics.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace arthoolbox {
+namespace stats {
+namespace {
+
+template <class It> double mean(It first, It last) {
+  return std::accumulate(first, last, 0.) / std::distance(first, last);
+}
+
+template <class It> double variance(It first, It last) {
+  const auto m = mean(first, last);
+  double sum = 0;
+  for (auto it = first; it != last; ++it)
+    sum += std::pow(*it - m, 2);
+  return sum / std::distance(first, last);
+}
+
+TEST(WindowedStatistics, MatchesTheLastNSamples) {
+  constexpr std::size_t window = 64;
+
+  std::mt19937 random_generator(42);
+  std::normal_distribution<double> distribution(50, 5e-3);
+
+  std::vector<double> samples;
+  WindowedStatistics<double, window> statistician;
+  ASSERT_EQ(statistician.getWindowSize(), window);
+
+  for (std::size_t i = 0; i < 10 * window; ++i) {
+    samples.push_back(distribution(random_generator));
+    statistician.updateWith(samples.back());
+
+    const auto n = std::min(samples.size(), window);
+    const auto first = std::prev(samples.cend(), n);
+
+    ASSERT_EQ(statistician.getNumberOfMeasurements(), n);
+    ASSERT_NEAR(statistician.getMean(), mean(first, samples.cend()), 1e-9);
+    ASSERT_NEAR(statistician.getVariance(), variance(first, samples.cend()),
+                1e-9);
+  }
+
+  statistician.reset();
+  ASSERT_EQ(statistician.getNumberOfMeasurements(), 0);
+  ASSERT_EQ(statistician.getMean(), 0);
+}
+
+TEST(WindowedStatistics, StepChange) {
+  WindowedStatistics<double, 4> statistician;
+  for (int i = 0; i < 4; ++i)
+    statistician.updateWith(1.);
+
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 1.);
+  ASSERT_NEAR(statistician.getVariance(), 0., 1e-12);
+
+  // The window is now [1, 1, 5, 5]
+  statistician.updateWith(5.);
+  statistician.updateWith(5.);
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 3.);
+  ASSERT_DOUBLE_EQ(statistician.getVariance(), 4.);
+  ASSERT_DOUBLE_EQ(statistician.getSampledVariance(), 16. / 3.);
+
+  // The old values completly left the window
+  statistician.updateWith(5.);
+  statistician.updateWith(5.);
+  ASSERT_DOUBLE_EQ(statistician.getMean(), 5.);
+  ASSERT_NEAR(statistician.getVariance(), 0., 1e-12);
+}
+
+TEST(WindowedStatistics, NoDriftOnLongRuns) {
+  constexpr std::size_t window = 10;
+
+  std::mt19937 random_generator(42);
+  std::uniform_real_distribution<double> distribution(-1e8, 1e8);
+
+  WindowedStatistics<double, window> statistician;
+  for (std::size_t i = 0; i < 100000 * window; ++i)
+    statistician.updateWith(distribution(random_generator));
+
+  // A constant signal: the errors accumulated by the huge values are gone
+  for (std::size_t i = 0; i < window; ++i) {
+    statistician.updateWith(0.1);
+    ASSERT_GE(statistician.getVariance(), 0.);
+  }
+  ASSERT_EQ(statistician.getMean(), 0.1);
+  ASSERT_EQ(statistician.getVariance(), 0.);
+}
+
+} // namespace
+} // namespace stats
+} // namespace arthoolbox
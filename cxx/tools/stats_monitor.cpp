@@ -0,0 +1,44 @@
+/**
+ *   \file stats_monitor.cpp
+ *   \brief Print the statistics published by a StatisticsPublisher
+ *
+ *   Usage: arthoolbox_stats_monitor <shm name> [period ms]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <system_error>
+#include <thread>
+
+#include "arthoolbox/math/shared_statistics.hpp"
+
+int main(int argc, char *argv[]) {
+  if ((argc < 2) or (argc > 3)) {
+    std::cerr << "Usage: " << argv[0] << " <shm name> [period ms]\n";
+    return EXIT_FAILURE;
+  }
+
+  const auto period =
+      std::chrono::milliseconds(argc == 3 ? std::atol(argv[2]) : 1000);
+
+  try {
+    const arthoolbox::stats::StatisticsSubscriber subscriber(argv[1]);
+
+    std::uint64_t last_publication = 0;
+    arthoolbox::stats::RecurrentStatistics<double, double> stats;
+    while (true) {
+      const auto publication = subscriber.getNumberOfPublications();
+      if ((publication != last_publication) and subscriber.read(stats)) {
+        last_publication = publication;
+        std::cout << '#' << publication << ' '
+                  << arthoolbox::stats::format(stats) << std::endl;
+      }
+      std::this_thread::sleep_for(period);
+    }
+  } catch (const std::system_error &error) {
+    std::cerr << error.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}